@@ -1,1067 +1,6470 @@
-#include <iostream>
-#include <fstream>
-#include <cstdlib>
-#include <ctime>
-#include <vector>
-#include <string>
-#include <sstream>
-
-using namespace std;
-
-// Forward declarations
-class Passenger;
-class FlightState;
-class Flight;
-class Crew;
-class Airline;
-class PricingEngine;
-class FileHandler;
-class ScheduledState;
-class CancelledState;
-class DelayedState;
-class Observer;
-class PassengerObserver;
-class CrewObserver;
-class Reservation;
-
-// Enum for crew states (Available or Training)
-enum class CrewState {
-    Available,
-    Training
-};
-
-// Enum for crew roles
-enum class CrewRole {
-    Pilot,
-    CoPilot,
-    FlightAttendant
-};
-
-// Enum for seat types
-enum class SeatType {
-    Economy,
-    Business,
-    FirstClass
-};
-
-// Function to convert SeatType enum to string
-string convertSeatTypeToString(SeatType seatType) {
-    switch (seatType) {
-    case SeatType::Economy:
-        return "Economy";
-    case SeatType::Business:
-        return "Business";
-    case SeatType::FirstClass:
-        return "FirstClass";
-    }
-    return "";
-}
-
-
-
-// PricingEngine class 
-
-//calculate the final price of ticket according to provided factors like seasonal factor, event factor and demand factor
-class PricingEngine {
-private:
-    //PricingStrategy* strategy;
-    double seasonalFactor;
-    double eventFactor;
-    double demandFactor;
-
-public:
-
-    PricingEngine(double sf = 1,double ef = 1 , double df = 1) : seasonalFactor(sf),eventFactor(ef),demandFactor(df){}
-	/*If seasonalFactor is non-zero, basePrice is multiplied by seasonalFactor; otherwise, basePrice remains unchanged.
-If eventFactor is non-zero, the intermediate result is further multiplied by eventFactor.
-If demandFactor is non-zero, the result is finally multiplied by demandFactor.
-This ensures that the final price is adjusted according to the provided factors.*/
-  
-    double calculatePrice(double basePrice) {
-        double ans = (seasonalFactor ? basePrice * seasonalFactor : basePrice);
-        if (eventFactor) ans *= eventFactor;
-        if (demandFactor) ans *= demandFactor;
-        return ans;
-    }
-};
-
-// FileHandler class (Facade for handling file operations)
-class FileHandler {
-private:
-    string filePath;
-
-public:
-    FileHandler(string filePath) : filePath(filePath) {}
-
-    void readData(Airline& airline);
-
-    void updateData(string route, double basePrice, double demandFactor, double seasonalFactor, double eventFactor);
-};
-
-// FlightState interface
-class FlightState {
-public:
-    string status;
-    virtual void updateStatus(string status) = 0;
-};
-
-// ScheduledState concrete state
-class ScheduledState : public FlightState {
-public:
-    //string status;
-    void updateStatus(string status) override {
-        // Implement updating flight status to Scheduled
-        this->status = "Scheduled";
-    }
-};
-
-// CancelledState concrete state
-class CancelledState : public FlightState {
-public:
-    //string status;
-    void updateStatus(string status) override {
-        // Implement updating flight status to Cancelled
-        this->status = "Cancelled";
-    }
-};
-
-// DelayedState concrete state
-class DelayedState : public FlightState {
-public:
-    //string status;
-    void updateStatus(string status) override {
-        // Implement updating flight status to delayed
-        this->status = "Delayed";
-    }
-};
-
-// Observer interface
-class Observer {
-public:
-    virtual void update() = 0;
-};
-
-// PassengerObserver concrete observer
-class PassengerObserver : public Observer {
-public:
-    void update() override {
-        // No Implementation Required
-    }
-};
-
-// CrewObserver concrete observer
-class CrewObserver : public Observer {
-public:
-    void update() override {
-        // No Implementation Required
-    }
-};
-
-// Airline class
-class Airline {
-private:
-    string name;
-    vector<Flight*> flights;
-    vector<Crew*> crews;
-    vector<Passenger*> passengers;
-public:
-    Airline(string name) : name(name) {}
-
-    // Getter for name, name
-    string getName() const {
-        return name;
-    }
-
-    // Getter for flights , return flights
-    //Returns a constant reference to the vector of flights pointers.
-    const vector<Flight*>& getFlights() const {
-        return flights;
-    }
-
-    // Getter for crews, return crew
-    //Returns a constant reference to the vector of crews pointers.
-    const vector<Crew*>& getCrews() const {
-        return crews;
-    }
-
-    // Getter for passengers return passenger
-    //Returns a constant reference to the vector of passengers pointers.
-    const vector<Passenger*>& getPassengers() const {
-        return passengers;
-    }
-
-    void addFlight(Flight* flight) {
-        flights.push_back(flight);
-    }
-
-   
-
-    void addCrew(Crew* crew) {
-        crews.push_back(crew);
-    }
-
-    void removeCrew(Crew* crew) {
-        // Implement removal logic
-        for (int i = 0; i < crews.size(); i++) {
-            if (crews[i] == crew) {
-                for (int j = i; j < crews.size() - 1; j++) {
-                    crews[i] = crews[i + 1];
-                }
-                crews.pop_back();
-                break;
-            }
-        }
-    }
-
-    void assignCrewToFlight(Flight* flight, Crew* crew);
-
-    void handleScheduleConflicts(Flight* flight) {
-        // Handle schedule conflicts for the flight
-    }
-};
-
-// Flight class with state pattern integration
-class Flight {
-private:
-    int price;
-    string route;
-    vector<Passenger*> passengers;
-    vector<Crew*> crew;
-    FlightState* currentState;
-    string time;
-
-public:
-    Flight(string route , string time = "1 am ,Day 1",int price = 100) : route(route), time(time),price(price) {
-        currentState = new ScheduledState();
-        currentState->status = "Scheduled.\n";
-    }
-
-    void setPrice(int price) {
-        this->price = price;
-    }
-
-    int getPrice() {
-        return price;
-    }
-
-    // Getter for route
-    string getRoute() const {
-        return route;
-    }
-
-    // Getter for passengers
-    const vector<Passenger*>& getPassengers() const {
-        return passengers;
-    }
-
-    // Getter for crew
-    vector<Crew*>& getCrew() {
-        return crew;
-    }
-
-    void setRoute(string s) {
-        route = s;
-    }
-
-    // Getter for currentState
-    FlightState* getCurrentState() const {
-        return currentState;
-    }
-
-    FlightState*& getState() { return currentState; }
-
-    void updateSchedule(string status) {
-        currentState->updateStatus(status);
-    }
-
-    void setState(FlightState* state) {
-        currentState = state;
-        updateSchedule("Cancelled");
-    }
-
-    string getTime() const {
-        return time;
-    }
-
-    void removeCrew(int idx) {
-        for (int i = idx; i < crew.size()-1; i++) {
-            crew[i] = crew[i + 1];
-        }
-        crew.pop_back();
-    }
-
-    void setTime(string newTime) {
-        time = newTime;
-        //cout << "\nNew time has been set Successfully.\n";
-    }
-
-    void reroute(string newRoute) {
-
-        route = newRoute;
-    }
-
-    void makeReservation(Passenger* passenger, string seat) {
-        // Logic Already implemented
-    }
-};
-
-
-// Passenger class
-class Passenger {
-private:
-    string name;
-    vector<Reservation*> reservations;
-    bool loyaltyEligibility;
-    string seat;
-
-public:
-    Passenger(string name) : name(name), loyaltyEligibility(rand() % 2) {}
-
-    void bookFlight(Flight* flight, string seat) {
-        // Implemented
-    }
-
-    void cancelReservation(int idx) {
-        // Implement cancellation logic
-        for (int i = idx; i < reservations.size() - 1; i++) {
-            reservations[i] = reservations[i + 1];
-        }
-        reservations.pop_back();
-
-        cout << "Your Desired Reservation has been successfully removed.\n";
-    }
-
-    vector<Reservation*>& getReservations() { return reservations; }
-
-    void modifyReservation(int idx);
-
-    void setName(string name) {
-        this->name = name;
-    }
-
-    void setSeat(string newSeat) {
-        seat = newSeat;
-    }
-
-    bool getEligibility() const {
-        return loyaltyEligibility;
-    }
-};
-
-// Reservation Class
-class Reservation {
-private:
-    vector<Passenger*> passengers;
-    vector<Flight*> flights;
-    string seat;
-    string specialRequest;
-    //size_t is data type of integer, unassigned data type use for size and count
-    int numPassengers;
-    int numFlights;
-
-public:
-    Reservation(vector<Passenger*> passengers = {}, vector<Flight*> flights = {}, string seat = "")
-        : passengers(passengers), flights(flights), seat(seat) {
-        numPassengers = passengers.size();
-        numFlights = flights.size();
-    }
-
-    Reservation(Flight* flight, string seat) : seat(seat) {
-        flights.push_back(flight);
-    }
-
-    void changeSeat(string newSeat) {
-        // Implement special request to change seat
-        seat = newSeat;
-    }
-
-    // Getters
-    vector<Passenger*>& getPassengers() {
-        return passengers;
-    }
-
-    vector<Flight*>& getFlights() {
-        return flights;
-    }
-
-    string getSeat() {
-        return seat;
-    }
-
-    string getSpecialRequest() {
-        return specialRequest;
-    }
-
-    size_t getNumPassengers() {
-        return numPassengers;
-    }
-
-    size_t getNumFlights() {
-        return numFlights;
-    }
-
-    // Setters
-    void setPassengers(vector<Passenger*> newPassengers) {
-        passengers = newPassengers;
-        numPassengers = passengers.size();
-    }
-
-    void setFlights(vector<Flight*> newFlights) {
-        flights = newFlights;
-        numFlights = flights.size();
-    }
-
-    void setSeat(string newSeat) {
-        seat = newSeat;
-    }
-
-    void setSpecialRequest(string newSpecialRequest) {
-        specialRequest = newSpecialRequest;
-    }
-};
-
-void Passenger::modifyReservation(int idx) {
-    // Implement modification logic
-    cout << "You have the option to modify which kind of seat you want to reserve.\n";
-    int seatChoice;
-    cout << "Please choose the seat type:\n";
-    cout << "1. Economy\n";
-    cout << "2. Business\n";
-    cout << "3. FirstClass\n";
-    cin >> seatChoice;
-    while (cin.fail() || seatChoice < 1 || seatChoice > 3) {
-        cout << "Please Enter a valid value: \n";
-        cin >> seatChoice;
-    }
-    SeatType chosenSeatType;
-    switch (seatChoice) {
-    case 1:
-        chosenSeatType = SeatType::Economy;
-        break;
-    case 2:
-        chosenSeatType = SeatType::Business;
-        break;
-    case 3:
-        chosenSeatType = SeatType::FirstClass;
-        break;
-    default:
-        cout << "Invalid seat choice\n";
-        break;
-    }
-    seat = convertSeatTypeToString(chosenSeatType);
-    reservations[idx]->changeSeat(seat);
-    cout << "Your Given Seat Type is Successfully Modified.\n";
-}
-
-// Crew class
-class Crew {
-private:
-    string name;
-    string role;
-    vector<Flight*> flights;
-    CrewState curr; // States of crew (Available or training)
-    bool compliance; // Compliance with aviation regulations
-
-public:
-    Crew(string name, string role, CrewState curr, bool compliance)
-        : name(name), role(role), curr(curr), compliance(compliance) {}
-
-    // Getters
-    string getName() const { return name; }
-    string getRole() const { return role; }
-    vector<Flight*> getFlights() const { return flights; }
-    CrewState getState() const { return curr; }
-    bool getCompliance() const { return compliance; }
-
-    // Setters
-    void setName(string name) { this->name = name; }
-    void setRole(string role) { this->role = role; }
-    void setFlights(vector<Flight*> flights) { this->flights = flights; }
-    void setState(CrewState state) { this->curr = state; }
-    void setCompliance(bool compliance) { this->compliance = compliance; }
-
-    void assignFlight(Flight* flight) {
-        flights.push_back(flight);
-    }
-
-    void removeFlight(Flight* flight) {
-        // Implemented removal logic
-    }
-
-    void resolveScheduleConflict(Flight* flight, string newRoute) {
-        // Resolved scheduling conflicts by changing the route of a flight
-    }
-};
-
-
-// Implementation of FileHandler readData method
-void FileHandler::readData(Airline& airline) {
-    ifstream file(filePath);
-    if (!file.is_open()) {
-        cerr << "Error: Unable to open file " << filePath << endl;
-        return;
-    }
-
-    string line;
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string route, flightState, crewName, crewRole, crewComplianceStr, crewStateStr;
-        getline(ss, route, ',');
-        getline(ss, flightState, ',');
-        getline(ss, crewName, ',');
-        getline(ss, crewRole, ',');
-        getline(ss, crewComplianceStr, ',');
-        getline(ss, crewStateStr);
-
-        bool crewCompliance = (crewComplianceStr == "1");
-        CrewState crewState = (crewStateStr == "Available") ? CrewState::Available : CrewState::Training;
-
-        FlightState* currentState;
-        if (flightState == "Scheduled") {
-            currentState = new ScheduledState();
-        }
-        else if (flightState == "Cancelled") {
-            currentState = new CancelledState();
-        }
-        else if (flightState == "Delayed") {
-            currentState = new DelayedState();
-        }
-        else {
-            cerr << "Error: Invalid flight state encountered: " << flightState << endl;
-            continue;
-        }
-
-        Flight* flight = new Flight(route);
-        flight->setState(currentState);
-        flight->setPrice(100 + rand() % 50);
-
-        Crew* crew = new Crew(crewName, crewRole, crewState, crewCompliance);
-        airline.addFlight(flight);
-        airline.addCrew(crew);
-    }
-
-    file.close();
-}
-
-// Implementation of FileHandler updateData method
-void FileHandler::updateData(string route, double basePrice, double demandFactor, double seasonalFactor, double eventFactor) {
-    // Implement updating pricing factors in final_draft.csv
-}
-
-void Airline::assignCrewToFlight(Flight* flight, Crew* crew) {
-    // Assign crew to the flight
-    flight->getCrew().push_back(crew);
-    removeCrew(crew);
-
-}
-
-int main() {
-	//generate random numbers for time but current time for booking of flight 
-    srand(time(0));
-
-    cout << " ~*~*~*~*~*~*~* Welcome to Airline Reservation System Simulation *~*~*~*~*~*~*~\n";
-    string a_name; // Airline name
-    cout << "Enter the name for the Airline : ";
-    getline(cin, a_name);
-
-    PricingEngine price(1.2, 1, 1.3); // These are the hard coded factors
-
-    // Create airline object
-    Airline airline(a_name);
-    // Initializing the reservation system
-    Reservation reservations;
-
-    // Load data using file handler
-    //read data from file that is created in drive
-    FileHandler fileHandler("final_draft.txt");
-    fileHandler.readData(airline);
-
-
-    // Menu to choose observer state
-    cout << "\nChoose observer state:\n";
-    cout << "1. Passenger Observer\n";
-    cout << "2. Head Observer\n";
-    int observerChoice;
-    cin >> observerChoice;
-    // cin.fail() Checks if the previous input operation failed (e.g., if the user entered a non-integer).
-    while (cin.fail() || observerChoice < 1 || observerChoice > 2) {
-        cout << "Please Enter a Valid Observer Type: ";
-        cin >> observerChoice;
-    }
-    // Creating pointer observer object of base based on choice
-    Observer* observer = nullptr;
-    if (observerChoice == 1) {
-    	// dynamically allocating the derived object address  to pointer object of parent observer
-        observer = new PassengerObserver();
-    }
-    else if (observerChoice == 2) {
-        observer = new CrewObserver();
-        // Setting up time for each flight
-        for (int i = 0; i < airline.getFlights().size(); i++) {
-            string time = to_string((i + 1) % 12 + 1) + ((i % 24) < 13 ? " pm" : " am") + ", Day " + to_string(i / 10 + 1);
-            airline.getFlights()[i]->setTime(time);
-        }
-    }
-    else {
-        cout << "Invalid choice\n";
-        return 1;
-    }
-
-    bool Flag = 0; // for taking name of the passenger only once
-    //bool Flag2 = 0; // For Checking if the passenger has any reservations
-    Passenger newPassenger("");
-    // Handling choices for functionalities
-    int choice;
-    do {
-        cout << "\nChoose an option:\n";
-        if (observerChoice == 1) {
-            cout << "1. Book a flight\n";
-            cout << "2. Cancel a reservation\n";
-            cout << "3. Modify a reservation\n";
-            cout << "4. Exit\n";
-        }
-        else if (observerChoice == 2) {
-            cout << "1. Manage Crews to a flight\n"; // For adding and removing crews
-            cout << "2. Handle schedule conflicts\n";
-            cout << "3. Update flight status\n";
-            cout << "4. Reroute a flight\n";
-            cout << "5. Modify Flights \n"; // Adding and Removing
-            cout << "6. Exit\n";
-        }
-        cin >> choice;
-        int CrewNum;
-        int flightNum;
-        switch (choice) {
-        case 1: {
-            if (observerChoice == 1) {
-                // Book a flight
-                string passengerName;
-                if (!Flag) {
-                    cout << "Enter passenger name: ";
-
-                    getline(cin >> ws, passengerName); // ws for white space
-                }
-                int seatChoice;
-                cout << "Choose seat type:\n";
-                cout << "1. Economy\n";
-                cout << "2. Business\n";
-                cout << "3. FirstClass\n";
-                cin >> seatChoice;
-                while (cin.fail() || seatChoice < 1 || seatChoice > 3) {
-                    cout << "Please Enter a valid value: \n";
-                    cin >> seatChoice;
-                }
-                SeatType chosenSeatType;
-                switch (seatChoice) {
-                case 1:
-                    chosenSeatType = SeatType::Economy;
-                    break;
-                case 2:
-                    chosenSeatType = SeatType::Business;
-                    break;
-                case 3:
-                    chosenSeatType = SeatType::FirstClass;
-                    break;
-                default:
-                    cout << "Invalid seat choice\n";
-                    continue; // Go back to the main menu
-                }
-                string seat = convertSeatTypeToString(chosenSeatType);
-                if (!Flag) {
-                    newPassenger.setName(passengerName);
-                    Flag = 1;
-                }
-                cout << "You have the following Avaiable flights : \n";
-                for (int i = 0; i < airline.getFlights().size(); i++) {
-                    string time = to_string((i + 1) % 12 + 1) + ((i % 24) < 13 ? " pm" : " am") + ", Day " + to_string(i / 10 + 1);
-                    airline.getFlights()[i]->setTime(time);
-                    if (airline.getFlights()[i]->getCurrentState()->status == "Scheduled") {
-                        cout << " " << i + 1 << ": ~~~ " << airline.getFlights()[i]->getRoute() << ", Time : [ " << airline.getFlights()[i]->getTime() << " ]" << endl;
-                    }
-                    
-                }
-                int flightNum = 0;
-                cout << "Enter the flight you want to take : ";
-                cin >> flightNum;
-                while (cin.fail() || flightNum < 1 || flightNum > 37 || airline.getFlights()[flightNum - 1]->getCurrentState()->status != "Scheduled") {
-                    cout << "Please Enter a valid Flight Number : ";
-                    cin >> flightNum;
-                }
-
-                newPassenger.getReservations().push_back(new Reservation(airline.getFlights()[flightNum - 1], seat));
-                // Deleting OLD STATE
-                delete airline.getFlights()[flightNum - 1]->getCurrentState();
-                // Assigning New State
-                airline.getFlights()[flightNum - 1]->setState(new CancelledState);
-                //reservations.getFlights().push_back(new Flight());
-
-                if (seat == "Business") airline.getFlights()[flightNum - 1]->setPrice(airline.getFlights()[flightNum - 1]->getPrice() + 40);
-                else if(seat == "FirstClass") airline.getFlights()[flightNum - 1]->setPrice(airline.getFlights()[flightNum - 1]->getPrice() + 100);
-                string loyalityCheck;
-                cout << "Are you eligible for the loyality program? \n ";
-                cin >> loyalityCheck;
-                cout << "\nYou are successfully Registered in the Flight heading " << airline.getFlights()[flightNum - 1]->getRoute() << " \n";
-                cout << "Regardless of your input , We have decided that you are " << (newPassenger.getEligibility() ? "" : "not ") << "eligible for the loyality Program.\n";
-                cout << "\n\nConsidering All the Current Factors , Your final price comes out to be : " << price.calculatePrice(airline.getFlights()[flightNum - 1]->getPrice()) << "$ \n";
-            }
-            else if (observerChoice == 2) {
-                // Assign crew to a flight
-                cout << "Choose one of the following : \n";
-                cout << "1. Add crew to Flight\n";
-                cout << "2. Remove crew from Flight\n";
-                int choice = 0;
-                cin >> choice;
-                while (cin.fail() || choice < 1 || choice > 2) {
-                    cout << "Enter a Valid Option : ";
-                    cin >> choice;
-                }
-                switch (choice) {
-                case 1:
-                    cout << "You have the following Flights Available: \n";
-                    for (int i = 0; i < airline.getFlights().size(); i++) {
-                        //string time = to_string((i + 1) % 12 + 1) + ((i % 24) < 13 ? " pm" : " am") + ", Day " + to_string(i / 10 + 1);
-                        if (airline.getFlights()[i]->getCurrentState()->status == "Scheduled") {
-                            cout << " " << i + 1 << ": ~~~ " << airline.getFlights()[i]->getRoute() << ", Time : [ " << airline.getFlights()[i]->getTime() << " ]" << endl;
-                        }
-                        //airline.getFlights()[i]->setTime(time);
-                    }
-                    
-                    cout << "Enter the Flight number that you want to add the crew to : ";
-                    cin >> flightNum;
-                    while (cin.fail() || flightNum < 1 || flightNum > 37 || airline.getFlights()[flightNum - 1]->getCurrentState()->status != "Scheduled") {
-                        cout << "Please Enter a valid Flight Number : ";
-                        cin >> flightNum;
-                    }
-                    if (airline.getCrews().size()) {
-                        cout << "You Currently have the following crew : \n";
-                        for (int i = 0; i < airline.getCrews().size(); i++) {
-                            cout << " " << i + 1 << ". " << airline.getCrews()[i]->getName() << " [ " << airline.getCrews()[i]->getRole() << " ] \n";
-                        }
-                    }
-                    else cout << "No , Crew Available.\n";
-                    cout << "Enter the Crew Number that you want to assign to the this Flight : ";
-                    
-                    cin >> CrewNum;
-                    while (cin.fail() || CrewNum < 1 || CrewNum > airline.getCrews().size()) {
-                        cout << "Enter a Valid Crew no. : ";
-                        cin >> CrewNum;
-                    }
-                    if (airline.getCrews()[CrewNum - 1]->getCompliance()) {
-                        airline.assignCrewToFlight(airline.getFlights()[flightNum - 1], airline.getCrews()[CrewNum - 1]);
-                        cout << "Your Desired Crew is added to the desired Flight.\n";
-                    }
-                    else cout << " This Crew's compliance with aviation regulations is subpar.\n So, Please select another one next time.\n";
-                    break;
-                case 2:
-                    cout << "You have the following Flights Available: \n";
-                    for (int i = 0; i < airline.getFlights().size(); i++) {
-                        //string time = to_string((i + 1) % 12 + 1) + ((i % 24) < 13 ? " pm" : " am") + ", Day " + to_string(i / 10 + 1);
-                        if (airline.getFlights()[i]->getCurrentState()->status == "Scheduled") {
-                            cout << " " << i + 1 << ": ~~~ " << airline.getFlights()[i]->getRoute() << ", Time : [ " << airline.getFlights()[i]->getTime() << " ]" << endl;
-                        }
-                        //airline.getFlights()[i]->setTime(time);
-                    }
-                    
-                    cout << "Enter the Flight number that you want to remove the crew from : ";
-                    cin >> flightNum;
-                    while (cin.fail() || flightNum < 1 || flightNum > 37 || airline.getFlights()[flightNum - 1]->getCurrentState()->status != "Scheduled") {
-                        cout << "Please Enter a valid Flight Number : ";
-                        cin >> flightNum;
-                    }
-                    if (airline.getFlights()[flightNum-1]->getCrew().size()) {
-                        cout << "You Currently have the following crew : \n";
-                        for (int i = 0; i < airline.getFlights()[flightNum - 1]->getCrew().size(); i++) {
-                            cout << " " << i + 1 << ". " << airline.getFlights()[flightNum - 1]->getCrew()[i]->getName() << " [ " << airline.getFlights()[flightNum - 1]->getCrew()[i]->getRole() << " ] \n";
-                        }
-                    }
-                    else { 
-                        cout << "No , Crew Available.\n"; 
-                        break;
-                    }
-                    cout << "Enter the Crew Number that you want to remove from this flight : ";
-                    
-                    cin >> CrewNum;
-                    while (cin.fail() || CrewNum < 1 || CrewNum > airline.getFlights()[flightNum - 1]->getCrew().size()) {
-                        cout << "Enter a Valid Crew no. : ";
-                        cin >> CrewNum;
-                    }
-                    airline.addCrew(airline.getFlights()[flightNum - 1]->getCrew()[CrewNum - 1]);
-                    airline.getFlights()[flightNum - 1]->removeCrew(CrewNum-1);
-
-                    cout << "Your Desired Crew has been successfully removed from the inteneded Flight .\n";
-                    break;
-                default:
-                    cout << "This line is not supposed to print.\n";
-                }
-            }
-            break;
-        }
-        case 2: {
-            if (observerChoice == 1) {
-                // Cancel a reservation
-                // Implement cancellation logic
-                int FlightNum = 0;
-                if (newPassenger.getReservations().size()) {
-                    cout << "Currently , you have the following Flights : \n";
-                    for (int i = 0; i < newPassenger.getReservations().size(); i++) {
-                        cout << " " << i + 1 << ". Heading " << newPassenger.getReservations()[i]->getFlights()[i]->getRoute() << "  [ " << newPassenger.getReservations()[i]->getSeat() << " ] , Time : " << "[ " << newPassenger.getReservations()[i]->getFlights()[i]->getTime() << " ]" << endl;
-                    }
-                    cout << "Enter the flight no. that you want to cancel : ";
-                    cin >> FlightNum;
-                    while (cin.fail() || FlightNum < 1 || FlightNum > newPassenger.getReservations().size()) {
-                        cout << "Enter a Valid Flight no. : ";
-                        cin >> FlightNum;
-                    }
-                    if (rand() % 2 == 1) {
-                        cout << "Sorry , Your Cancellation Request can't be executed.\n";
-                        cout << "Do you want to make a Special Request ? (yes/no)\n";
-                        string ans;
-                        getline(cin >> ws, ans);
-                        while (ans != "yes" && ans != "no") {
-                            cout << "Enter a valid Option: ";
-                            getline(cin >> ws, ans);
-                        }
-                        if (ans == "no") {
-                            cout << "Sure ! \n";
-                            break;
-                        }
-                        string request;
-                        cout << "Enter the request you want to give : \n";
-                        getline(cin >> ws, request);
-                        newPassenger.getReservations()[FlightNum - 1]->setSpecialRequest(request);
-                        cout << "\nConsidering Your Special Request , we have made our decision.\n\n";
-                    }
-                    if (rand() % 2 == 1)
-                        newPassenger.cancelReservation(FlightNum);
-                    else cout << "You can't Cancel this flight.\n";
-                }
-                else cout << "You don't have any Reservations.\n";
-            }
-            else if (observerChoice == 2) {
-                // Handle schedule conflicts
-                static int DateCnt = 0;
-                static int DayCnt = 0;
-                cout << "You have the following Flights Available: \n";
-                for (int i = 0; i < airline.getFlights().size(); i++) {
-                    //string time = to_string((i + 1) % 12 + 1) + ((i % 24) < 13 ? " pm" : " am") + ", Day " + to_string(i / 10 + 1);
-                    if (airline.getFlights()[i]->getCurrentState()->status == "Scheduled") {
-                        cout << " " << i + 1 << ": ~~~ " << airline.getFlights()[i]->getRoute() << ", Time : [ " << airline.getFlights()[i]->getTime() << " ]" << endl;
-                    }
-                }
-
-                cout << "Enter the Flight number that you want to change schedule of the crew to : ";
-                cin >> flightNum;
-                while (cin.fail() || flightNum < 1 || flightNum > 37 || airline.getFlights()[flightNum - 1]->getCurrentState()->status != "Scheduled") {
-                    cout << "Please Enter a valid Flight Number : ";
-                    cin >> flightNum;
-                }
-                cout << "The next possible Time that you can set for this flight is : \n";
-                if (DateCnt / 24) DayCnt++;
-                string newTime =  to_string((1 + DateCnt++) % 12) + (DateCnt % 24 < 13 ? "pm" : "am")  + ", Day " + to_string(10+DayCnt);
-                cout << newTime << endl;
-                cout << "Do you want to Modify the previous time (yes/no)? ";
-                string timeopt;
-                cin >> timeopt;
-                while (timeopt != "yes" && timeopt != "no") {
-                    cout << "Give a valid answer : ";
-                    cin >> timeopt;
-                }
-                if (timeopt == "yes") {
-                    airline.getFlights()[flightNum - 1]->setTime(newTime);
-                }
-                cout << "Your Request has been fulfilled.\n";
-            }
-            break;
-        }
-        case 3: {
-            if (observerChoice == 1) {
-                // Modify a reservation
-                // Implement modification logic
-                int FlightNum = 0;
-                if (newPassenger.getReservations().size()) {
-                    cout << "Currently , you have the following Flights : \n";
-                    for (int i = 0; i < newPassenger.getReservations().size(); i++) {
-                        cout << " " << i + 1 << ". Heading " << newPassenger.getReservations()[i]->getFlights()[i]->getRoute() << "  [ " << newPassenger.getReservations()[i]->getSeat() << " ] , Time : " << "[ " << newPassenger.getReservations()[i]->getFlights()[i]->getTime() << " ]" << endl;
-                    }
-                    cout << "Enter the flight no. that you want to Modify : ";
-                    cin >> FlightNum;
-                    while (cin.fail() || FlightNum < 1 || FlightNum > newPassenger.getReservations().size()) {
-                        cout << "Enter a Valid Flight no. : ";
-                        cin >> FlightNum;
-                    }
-                    if (rand() % 2 == 1) {
-                        cout << "Sorry , Your Flight Modification Request can't be executed.\n";
-                        cout << "Do you want to make a Special Request ? (yes/no)\n";
-                        string ans;
-                        getline(cin >> ws, ans);
-                        while (ans != "yes" && ans != "no") {
-                            cout << "Enter a valid Option: ";
-                            getline(cin >> ws, ans);
-                        }
-                        if (ans == "no") {
-                            cout << "Sure ! \n";
-                            break;
-                        }
-                        string request;
-                        cout << "Enter the request you want to give : \n";
-                        getline(cin >> ws, request);
-                        newPassenger.getReservations()[FlightNum - 1]->setSpecialRequest(request);
-                        cout << "\nConsidering Your Special Request , we have made our decision.\n\n";
-                    }
-                    newPassenger.modifyReservation(FlightNum - 1);
-                }
-                else cout << "You don't have any Reservations.\n";
-            }
-            else if (observerChoice == 2) {
-                // Update flight status
-                cout << "You have the following Flights Available: \n";
-                for (int i = 0; i < airline.getFlights().size(); i++) {
-                    //string time = to_string((i + 1) % 12 + 1) + ((i % 24) < 13 ? " pm" : " am") + ", Day " + to_string(i / 10 + 1);
-                    //if (airline.getFlights()[i]->getCurrentState()->status == "Scheduled") {
-                    cout << " " << i + 1 << ": ~~~ " << airline.getFlights()[i]->getRoute() << ", Time : [ " << airline.getFlights()[i]->getTime() << " ]" << endl;
-                    //}
-                }
-                cout << "Select the one that you want to update the state of : \n";
-                cin >> flightNum;
-                while (cin.fail() || flightNum < 1 || flightNum > airline.getFlights().size()) {
-                    cout << "Please Enter a valid Flight Number : ";
-                    cin >> flightNum;
-                }
-                cout << "The Current State of the given flight is : " << airline.getFlights()[flightNum - 1]->getState()->status << ". \n";
-                cout << "Select any of the following Choices that you want the state to update to: \n";
-                cout << "1. Scheduled \n2. Delayed \n3.Cancelled\n";
-                int StChoice;
-                cin >> StChoice;
-                while (cin.fail() || StChoice < 1 || StChoice > 3) {
-                    cout << "Enter a valid Choice : ";
-                    cin >> StChoice;
-                }
-                switch (StChoice) {
-                case 1:
-                    delete airline.getFlights()[flightNum - 1]->getState();
-                    airline.getFlights()[flightNum - 1]->getState() = new ScheduledState();
-                    airline.getFlights()[flightNum - 1]->getState()->updateStatus("Scheduled");
-                    break;
-                case 2:
-                    delete airline.getFlights()[flightNum - 1]->getState();
-                    airline.getFlights()[flightNum - 1]->getState() = new DelayedState();
-                    airline.getFlights()[flightNum - 1]->getState()->updateStatus("Delayed");
-                    break;
-                case 3:
-                    delete airline.getFlights()[flightNum - 1]->getState();
-                    airline.getFlights()[flightNum - 1]->getState() = new CancelledState();
-                    airline.getFlights()[flightNum - 1]->getState()->updateStatus("Cancelled");
-                    break;
-                default:
-                    cout << "This line is not supposed to print.\n";
-                }
-                cout << "Your Required State has been set Successfully.\n";
-            }
-            break;
-        }
-        case 4: {
-            if (observerChoice == 1) {
-                // No action for Passenger Observer
-                cout << "Exiting...\n";
-                break;
-            }
-            else if (observerChoice == 2) {
-                // Reroute a flight
-                cout << "You have the following Flights Available: \n";
-                for (int i = 0; i < airline.getFlights().size(); i++) {
-                    //string time = to_string((i + 1) % 12 + 1) + ((i % 24) < 13 ? " pm" : " am") + ", Day " + to_string(i / 10 + 1);
-                    if (airline.getFlights()[i]->getCurrentState()->status == "Scheduled") {
-                        cout << " " << i + 1 << ": ~~~ " << airline.getFlights()[i]->getRoute() << ", Time : [ " << airline.getFlights()[i]->getTime() << " ]" << endl;
-                    }
-                }
-                cout << "Enter the Flight number that you want to Reroute : ";
-                cin >> flightNum;
-                while (cin.fail() || flightNum < 1 || flightNum > 37 || airline.getFlights()[flightNum - 1]->getCurrentState()->status != "Scheduled") {
-                    cout << "Please Enter a valid Flight Number : ";
-                    cin >> flightNum;
-                }
-                cout << "Enter the Route you want it to follow : \n";
-                string newRoute;
-                cin >> newRoute;
-                airline.getFlights()[flightNum - 1]->setRoute(newRoute);
-                cout << "Your desired Flight has been rerouted successfully.\n";
-            }
-            break;
-        }
-        case 5: {
-            // Logic To Add/Remove Flights
-            if (observerChoice == 2) {
-                cout << "Select one of the following options: \n";
-                cout << "1. Add Flight\n"
-                    << "2. Remove Flight\n";
-                int flChoice;
-                cin >> flChoice;
-                while (cin.fail() || flChoice < 1 || flChoice > 2) {
-                    cout << "Choose a Valid Option: ";
-                    cin >> flChoice;
-                }
-                if (flChoice == 1) {
-                    cout << "Enter the route for the new Flight.\n";
-                    string newRoute;
-                    cin >> newRoute;
-                    cout << "Now select any of the following times : \n"
-                        << "1. 10 pm , Day 7\n2. 11 am ,Day 8\n3. 6 pm , Day 8\n4. 9 pm , Day 8\n";
-                    int timeChoice;
-                    cin >> timeChoice;
-                    while (cin.fail() || timeChoice < 1 || timeChoice > 4) {
-                        cout << "Enter a Valid Option: ";
-                        cin >> timeChoice;
-                    }
-                    string newtime;
-                    switch (timeChoice) {
-                    case 1:
-                        newtime = "10 pm , Day 7";
-                        break;
-                    case 2:
-                        newtime = "11 am ,Day 8";
-                        break;
-                    case 3:
-                        newtime = "6 pm , Day 8";
-                        break;
-                    case 4:
-                        newtime = "9 pm , Day 8";
-                        break;
-                    }
-                    Flight* newFlight = new Flight(newRoute,newtime);
-                    airline.addFlight(newFlight);
-                    cout << "Your Desired Flight has been added successfully.\n";
-                }
-                else {
-                    cout << "You have the following Flights Available: \n";
-                    for (int i = 0; i < airline.getFlights().size(); i++) {
-                        //string time = to_string((i + 1) % 12 + 1) + ((i % 24) < 13 ? " pm" : " am") + ", Day " + to_string(i / 10 + 1);
-                        //if (airline.getFlights()[i]->getCurrentState()->status == "Scheduled") {
-                            cout << " " << i + 1 << ": ~~~ " << airline.getFlights()[i]->getRoute() << ", Time : [ " << airline.getFlights()[i]->getTime() << " ]" << endl;
-                        //}
-                    }
-
-                    cout << "Enter the Flight number that you want to remove : ";
-                    cin >> flightNum;
-                    while (cin.fail() || flightNum < 1 || flightNum > airline.getFlights().size()) {
-                        cout << "Please Enter a valid Flight Number : ";
-                        cin >> flightNum;
-                    }
-               //     airline.removeFlight(airline.getFlights()[flightNum - 1]);
-                    cout << "Your intended Flight has been removed successfully.\n";
-                }
-            }
-            break;
-        }
-        case 6: {
-            if (observerChoice == 2) {
-                cout << "Exiting...\n";
-                break;
-            }
-        }
-        default:
-            cout << "\nInvalid choice. Please Enter Again: ";
-        }
-    } while ((choice != 6 && observerChoice == 2) || (choice != 4 && observerChoice == 1));
-    delete observer;
-    return 0;
-}
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <string_view>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <atomic>
+#include <shared_mutex>
+#include <random>
+#include <filesystem>
+#include <cstdio>
+#include <climits>
+#include <cfloat>
+#include <cmath>
+#ifdef _WIN32
+#include <io.h>
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Forward declarations
+class Passenger;
+class FlightState;
+class Flight;
+class Crew;
+class Airline;
+class PricingEngine;
+class FileHandler;
+class ScheduledState;
+class CancelledState;
+class DelayedState;
+class Observer;
+class PassengerObserver;
+class CrewObserver;
+class CrewPool;
+class NotificationBus;
+class Reservation;
+struct DutyViolation;
+
+// Enum for crew states (Available or Training)
+enum class CrewState {
+    Available,
+    Training
+};
+
+// Enum for crew roles
+enum class CrewRole {
+    Pilot,
+    CoPilot,
+    FlightAttendant
+};
+
+// Number of CrewRole values
+const int CREW_ROLE_COUNT = 3;
+
+// Crew every flight must carry, indexed by CrewRole
+const int CREW_MIX[CREW_ROLE_COUNT] = { 1, 1, 2 };
+
+// Enum for seat types
+enum class SeatType {
+    Economy,
+    Business,
+    FirstClass
+};
+
+// Enum for flight status, the tag of every FlightState
+enum class FlightStatus : uint8_t {
+    Scheduled,
+    Delayed,
+    Cancelled
+};
+
+// Number of FlightStatus values
+const int FLIGHT_STATUS_COUNT = 3;
+
+// Converts "Scheduled", "Delayed" or "Cancelled" to FlightStatus, defined with the FlightState classes
+bool convertStringToFlightStatus(string_view text, FlightStatus& status);
+
+// Function to convert SeatType enum to string
+string convertSeatTypeToString(SeatType seatType) {
+    switch (seatType) {
+    case SeatType::Economy:
+        return "Economy";
+    case SeatType::Business:
+        return "Business";
+    case SeatType::FirstClass:
+        return "FirstClass";
+    }
+    return "";
+}
+
+// Converts "Pilot", "CoPilot" or "FlightAttendant" to CrewRole, returns false for any other role
+bool convertStringToCrewRole(string_view text, CrewRole& role) {
+    if (text == "Pilot") role = CrewRole::Pilot;
+    else if (text == "CoPilot") role = CrewRole::CoPilot;
+    else if (text == "FlightAttendant") role = CrewRole::FlightAttendant;
+    else return false;
+    return true;
+}
+
+// Function to convert a seat string ("Economy", "Business", "FirstClass") back to SeatType
+SeatType convertStringToSeatType(const string& seat) {
+    if (seat == "Business") return SeatType::Business;
+    if (seat == "FirstClass") return SeatType::FirstClass;
+    return SeatType::Economy;
+}
+
+// Converts a flight time such as "5 pm, Day 1", "10 pm , Day 7" or "6:30 am, Day 2" to minutes
+// after midnight of Day 1, the time every departure is counted from
+// Returns -1 if the text is not in that form
+int parseFlightTime(const string& text) {
+    int hour = -1, minute = 0, day = -1;
+    bool pm = false, meridiem = false;
+    size_t i = 0;
+    auto readNumber = [&text, &i]() {
+        int value = 0;
+        size_t start = i;
+        while (i < text.size() && isdigit(static_cast<unsigned char>(text[i]))) value = value * 10 + (text[i++] - '0');
+        return i > start ? value : -1;
+    };
+    while (i < text.size() && text[i] == ' ') i++;
+    hour = readNumber();
+    if (i < text.size() && text[i] == ':') {
+        i++;
+        minute = readNumber();
+    }
+    while (i < text.size() && text[i] == ' ') i++;
+    if (text.compare(i, 2, "am") == 0 || text.compare(i, 2, "pm") == 0) {
+        meridiem = true;
+        pm = text[i] == 'p';
+        i += 2;
+    }
+    size_t dayAt = text.find("Day", i);
+    if (dayAt != string::npos) {
+        i = dayAt + 3;
+        while (i < text.size() && text[i] == ' ') i++;
+        day = readNumber();
+    }
+    if (hour < 1 || hour > 12 || minute < 0 || minute > 59 || !meridiem || day < 1) return -1;
+    return (day - 1) * 24 * 60 + (hour % 12 + (pm ? 12 : 0)) * 60 + minute;
+}
+
+// Converts minutes after midnight of Day 1 back to the "5 pm, Day 1" form
+string formatFlightTime(int minutes) {
+    int hour = minutes / 60 % 24;
+    string clock = to_string(hour % 12 ? hour % 12 : 12);
+    if (minutes % 60) clock += (minutes % 60 < 10 ? ":0" : ":") + to_string(minutes % 60);
+    return clock + (hour < 12 ? " am" : " pm") + ", Day " + to_string(minutes / (24 * 60) + 1);
+}
+
+// Length of a departure slot, conflicts are resolved by moving a flight to a free slot
+const int SLOT_MINUTES = 60;
+
+// Minutes every flight is planned to take, the schedule only has departure times
+const int BLOCK_MINUTES = 180;
+
+// Least time between arriving on one leg and departing on the next
+const int MIN_CONNECTION_MINUTES = 45;
+
+// Least rest a crew gets between the end of one duty and the start of the next
+const int MIN_REST_MINUTES = 10 * 60;
+
+// Outcome of checking a crew duty against the crew's other duties
+enum class DutyConflict : uint8_t {
+    None,
+    Overlap, // The crew is flying another flight at the time
+    ShortRest // The crew would rest less than MIN_REST_MINUTES in between
+};
+
+// Duties of one crew keyed by (departure, flight id)
+using DutyMap = map<pair<int, int>, Flight*>;
+
+// Checks a duty departing at start against the duties either side of it, O(log n).
+// Every flight lasts BLOCK_MINUTES, so the closest duty before it ends last and the
+// closest one after it starts first. clash is set to the flight it conflicts with.
+DutyConflict checkDutyAt(const DutyMap& duties, int start, Flight** clash = nullptr) {
+    int end = start + BLOCK_MINUTES;
+    DutyConflict result = DutyConflict::None;
+    auto after = duties.lower_bound({ start, INT_MIN });
+    auto note = [&](DutyConflict conflict, Flight* other) {
+        if (conflict <= result) return;
+        result = conflict;
+        if (clash) *clash = other;
+    };
+    if (after != duties.end()) {
+        int next = after->first.first;
+        if (next < end) note(DutyConflict::Overlap, after->second);
+        else if (next < end + MIN_REST_MINUTES) note(DutyConflict::ShortRest, after->second);
+    }
+    if (after != duties.begin()) {
+        auto before = prev(after);
+        int previousEnd = before->first.first + BLOCK_MINUTES;
+        if (previousEnd > start) note(DutyConflict::Overlap, before->second);
+        else if (previousEnd + MIN_REST_MINUTES > start) note(DutyConflict::ShortRest, before->second);
+    }
+    return result;
+}
+
+// Departure of the flight on the given row of the schedule file, which has no time column.
+// Rows are spread over hourly slots, ten to a day.
+int scheduleFileDeparture(size_t row) {
+    int hour = static_cast<int>((row + 1) % 12 + 1);
+    bool pm = row % 24 < 13;
+    return static_cast<int>(row / 10) * 24 * 60 + (hour % 12 + (pm ? 12 : 0)) * 60;
+}
+
+// Number of cabins on every flight (one per SeatType)
+const int CABIN_COUNT = 3;
+
+// Amount added to the flight's base price for each cabin
+const int CABIN_SURCHARGE[CABIN_COUNT] = { 0, 40, 100 };
+
+// Extra fraction of the fare charged for a full cabin, the multiplier grows linearly with load
+const double DEMAND_SENSITIVITY = 0.5;
+
+// Index of lowest set bit of a non-zero word
+inline int lowestSetBit(uint64_t word) {
+    return __builtin_ctzll(word);
+}
+
+// SeatMap class
+// Keeps one bitset per cabin where a set bit means the seat is free.
+// A summary word per cabin has bit w set while word w still has a free seat,
+// so reserving, releasing and finding the first free seat are a few bit
+// operations per cabin instead of a scan over the seats.
+// All words are atomic: a seat is claimed with a compare-and-swap on its word, so
+// sessions racing for the same cabin never block each other and a full cabin is
+// reported without waiting. The summary is a hint that may briefly show an empty
+// word as free, never the other way round.
+class SeatMap {
+public:
+    // Largest cabin the summary word can index (64 words of 64 seats)
+    static const int MAX_CABIN_SEATS = 64 * 64;
+
+    // Failed compare-and-swaps in a row before a claim yields its time slice
+    static const int CLAIM_SPIN_LIMIT = 16;
+
+private:
+    struct Cabin {
+        int firstWord = 0; // Offset of the cabin's bitset in words
+        atomic<uint64_t> summary{ 0 };
+        int capacity = 0;
+        atomic<int> freeSeats{ 0 };
+    };
+    Cabin cabins[CABIN_COUNT];
+    unique_ptr<atomic<uint64_t>[]> words; // Bitsets of all cabins back to back, one allocation per flight
+
+    // Contention counters of the flight
+    atomic<uint64_t> casRetries{ 0 }; // Claims that lost a compare-and-swap and tried again
+    atomic<uint64_t> soldOutClaims{ 0 }; // Claims refused because the cabin was full
+
+    Cabin& cabin(SeatType type) { return cabins[static_cast<int>(type)]; }
+    const Cabin& cabin(SeatType type) const { return cabins[static_cast<int>(type)]; }
+    atomic<uint64_t>& word(const Cabin& c, int w) const { return words[c.firstWord + w]; }
+
+    static int wordCount(int capacity) {
+        return (capacity + 63) / 64;
+    }
+
+    static int clampCapacity(int capacity) {
+        if (capacity < 0) return 0;
+        return capacity > MAX_CABIN_SEATS ? MAX_CABIN_SEATS : capacity;
+    }
+
+    void initCabin(Cabin& c, int capacity, int firstWord) {
+        c.capacity = capacity;
+        c.freeSeats = capacity;
+        c.firstWord = firstWord;
+        uint64_t summary = 0;
+        for (int w = 0; w < wordCount(capacity); w++) {
+            // Clear the bits past the end of the cabin in the last word
+            int seatsInWord = capacity - w * 64;
+            word(c, w) = seatsInWord < 64 ? (1ULL << seatsInWord) - 1 : ~0ULL;
+            summary |= 1ULL << w;
+        }
+        c.summary = summary;
+    }
+
+    // Clears the summary bit of a word found empty, then puts it back if a release
+    // refilled the word in between so no free seat is ever hidden
+    void retireWord(Cabin& c, int w) {
+        c.summary.fetch_and(~(1ULL << w));
+        if (word(c, w).load()) c.summary.fetch_or(1ULL << w);
+    }
+
+public:
+    SeatMap(int economy = 120, int business = 24, int firstClass = 8) {
+        int capacities[CABIN_COUNT] = { clampCapacity(economy), clampCapacity(business), clampCapacity(firstClass) };
+        int total = 0;
+        for (int i = 0; i < CABIN_COUNT; i++) total += wordCount(capacities[i]);
+        words.reset(new atomic<uint64_t>[total]);
+        int firstWord = 0;
+        for (int i = 0; i < CABIN_COUNT; i++) {
+            initCabin(cabins[i], capacities[i], firstWord);
+            firstWord += wordCount(capacities[i]);
+        }
+    }
+
+    SeatMap(const SeatMap&) = delete;
+    SeatMap& operator=(const SeatMap&) = delete;
+
+    int capacity(SeatType type) const { return cabin(type).capacity; }
+    int freeSeats(SeatType type) const { return cabin(type).freeSeats.load(); }
+    int bookedSeats(SeatType type) const { return capacity(type) - freeSeats(type); }
+
+    uint64_t getCasRetries() const { return casRetries.load(); }
+    uint64_t getSoldOutClaims() const { return soldOutClaims.load(); }
+
+    bool isFree(SeatType type, int seat) const {
+        const Cabin& c = cabin(type);
+        if (seat < 0 || seat >= c.capacity) return false;
+        return (word(c, seat / 64).load() >> (seat % 64)) & 1ULL;
+    }
+
+    // Returns the lowest free seat number in the cabin, or -1 when it is full
+    int firstFree(SeatType type) const {
+        const Cabin& c = cabin(type);
+        uint64_t summary = c.summary.load();
+        while (summary) {
+            int w = lowestSetBit(summary);
+            uint64_t bits = word(c, w).load();
+            if (bits) return w * 64 + lowestSetBit(bits);
+            summary &= summary - 1;
+        }
+        return -1;
+    }
+
+    // Claims a specific seat, returns false if it is taken or out of range
+    bool reserveSeat(SeatType type, int seat) {
+        Cabin& c = cabin(type);
+        if (seat < 0 || seat >= c.capacity) return false;
+        int w = seat / 64;
+        uint64_t bit = 1ULL << (seat % 64);
+        uint64_t old = word(c, w).fetch_and(~bit);
+        if (!(old & bit)) return false;
+        if (old == bit) retireWord(c, w);
+        c.freeSeats.fetch_sub(1);
+        return true;
+    }
+
+    // Claims the lowest free seat of the cabin, returns its number or -1 when full.
+    // A lost compare-and-swap retries on the word's new value, moving on once the word is empty
+    int reserve(SeatType type) {
+        Cabin& c = cabin(type);
+        int failures = 0;
+        while (true) {
+            uint64_t summary = c.summary.load();
+            if (!summary) {
+                soldOutClaims.fetch_add(1, memory_order_relaxed);
+                return -1;
+            }
+            int w = lowestSetBit(summary);
+            atomic<uint64_t>& bits = word(c, w);
+            uint64_t expected = bits.load();
+            while (expected) {
+                uint64_t bit = expected & (~expected + 1);
+                if (bits.compare_exchange_weak(expected, expected & ~bit)) {
+                    if (expected == bit) retireWord(c, w);
+                    c.freeSeats.fetch_sub(1);
+                    return w * 64 + lowestSetBit(bit);
+                }
+                casRetries.fetch_add(1, memory_order_relaxed);
+                if (++failures % CLAIM_SPIN_LIMIT == 0) this_thread::yield();
+            }
+            retireWord(c, w);
+        }
+    }
+
+    // Gives a seat back to the cabin, returns false if it was not reserved
+    bool release(SeatType type, int seat) {
+        Cabin& c = cabin(type);
+        if (seat < 0 || seat >= c.capacity) return false;
+        int w = seat / 64;
+        uint64_t bit = 1ULL << (seat % 64);
+        if (word(c, w).fetch_or(bit) & bit) return false;
+        c.summary.fetch_or(1ULL << w);
+        c.freeSeats.fetch_add(1);
+        return true;
+    }
+};
+
+// Handle to an object in an ObjectPool, stays valid (and detectably stale) after the object is released
+struct PoolHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != UINT32_MAX; }
+};
+
+// Memory held by an ObjectPool
+struct PoolUsage {
+    size_t live = 0; // Objects in use
+    size_t free = 0; // Released slots waiting to be reused
+    size_t bytes = 0; // Storage allocated for objects and their slot data
+};
+
+// ObjectPool class
+// Hands out objects from large contiguous blocks instead of one heap allocation
+// per object. Objects keep their address until released, released slots are reused
+// before the pool grows, so a process that keeps creating and releasing stays flat.
+// Each slot carries a generation that is bumped on release, which is how a PoolHandle
+// notices the object it named is gone.
+template <typename T>
+class ObjectPool {
+private:
+    static const uint32_t NO_SLOT = UINT32_MAX;
+
+    // Slot data kept apart from the objects so traversals only touch the objects
+    struct Slot {
+        uint32_t generation = 0; // Odd while the slot holds a live object
+        uint32_t nextFree = NO_SLOT;
+    };
+
+    struct Block {
+        T* items;
+        Slot* slots;
+        size_t used;
+        size_t capacity;
+        uint32_t firstIndex;
+    };
+    vector<Block> blocks;
+    uint32_t freeHead = NO_SLOT;
+    size_t liveCount = 0;
+    size_t freeCount = 0;
+
+    void addBlock(size_t capacity) {
+        Block block;
+        block.items = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        block.slots = new Slot[capacity];
+        block.used = 0;
+        block.capacity = capacity;
+        block.firstIndex = blocks.empty() ? 0 : static_cast<uint32_t>(blocks.back().firstIndex + blocks.back().capacity);
+        blocks.push_back(block);
+    }
+
+    // Block holding the slot index, blocks are ordered by firstIndex
+    Block* blockOf(uint32_t index) {
+        auto it = upper_bound(blocks.begin(), blocks.end(), index, [](uint32_t i, const Block& b) { return i < b.firstIndex; });
+        if (it == blocks.begin()) return nullptr;
+        --it;
+        return index < it->firstIndex + it->used ? &*it : nullptr;
+    }
+
+    const Block* blockOf(uint32_t index) const {
+        return const_cast<ObjectPool*>(this)->blockOf(index);
+    }
+
+    // Block holding the object, or nullptr if it is not from this pool
+    Block* blockOf(const T* item) {
+        for (Block& block : blocks) {
+            if (item >= block.items && item < block.items + block.used) return &block;
+        }
+        return nullptr;
+    }
+
+public:
+    ObjectPool() {}
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    ~ObjectPool() {
+        clear();
+    }
+
+    // Makes sure the next n new objects come from one contiguous block
+    void reserve(size_t n) {
+        if (blocks.empty() || blocks.back().capacity - blocks.back().used < n) addBlock(n);
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Block* block;
+        size_t offset;
+        if (freeHead != NO_SLOT) {
+            block = blockOf(freeHead);
+            offset = freeHead - block->firstIndex;
+            freeHead = block->slots[offset].nextFree;
+            freeCount--;
+        }
+        else {
+            if (blocks.empty() || blocks.back().used == blocks.back().capacity) {
+                // Grow geometrically so a pool filled one object at a time still uses few blocks
+                addBlock(blocks.empty() ? 64 : blocks.back().capacity * 2);
+            }
+            block = &blocks.back();
+            offset = block->used++;
+        }
+        T* item = new (block->items + offset) T(std::forward<Args>(args)...);
+        block->slots[offset].generation++;
+        liveCount++;
+        return item;
+    }
+
+    // Destroys the object and keeps its slot for the next create
+    void release(T* item) {
+        Block* block = item ? blockOf(item) : nullptr;
+        if (!block) return;
+        size_t offset = item - block->items;
+        Slot& slot = block->slots[offset];
+        if (!(slot.generation & 1)) return;
+        item->~T();
+        slot.generation++;
+        slot.nextFree = freeHead;
+        freeHead = static_cast<uint32_t>(block->firstIndex + offset);
+        liveCount--;
+        freeCount++;
+    }
+
+    // Handle of a live object of this pool, or an invalid handle
+    PoolHandle handleOf(const T* item) {
+        PoolHandle handle;
+        Block* block = item ? blockOf(item) : nullptr;
+        if (!block) return handle;
+        size_t offset = item - block->items;
+        if (!(block->slots[offset].generation & 1)) return handle;
+        handle.index = static_cast<uint32_t>(block->firstIndex + offset);
+        handle.generation = block->slots[offset].generation;
+        return handle;
+    }
+
+    // Object named by the handle, or nullptr once it has been released
+    T* get(PoolHandle handle) const {
+        if (!handle.valid()) return nullptr;
+        const Block* block = blockOf(handle.index);
+        if (!block) return nullptr;
+        size_t offset = handle.index - block->firstIndex;
+        return block->slots[offset].generation == handle.generation ? block->items + offset : nullptr;
+    }
+
+    // Calls fn on every live object, in memory order
+    template <typename Fn>
+    void forEach(Fn fn) {
+        for (Block& block : blocks) {
+            for (size_t i = 0; i < block.used; i++) {
+                if (block.slots[i].generation & 1) fn(block.items + i);
+            }
+        }
+    }
+
+    // Destroys every object and frees all blocks in one go
+    void clear() {
+        for (Block& block : blocks) {
+            for (size_t i = 0; i < block.used; i++) {
+                if (block.slots[i].generation & 1) block.items[i].~T();
+            }
+            ::operator delete(block.items);
+            delete[] block.slots;
+        }
+        blocks.clear();
+        freeHead = NO_SLOT;
+        liveCount = 0;
+        freeCount = 0;
+    }
+
+    size_t size() const { return liveCount; }
+
+    PoolUsage usage() const {
+        PoolUsage result;
+        result.live = liveCount;
+        result.free = freeCount;
+        for (const Block& block : blocks) result.bytes += block.capacity * (sizeof(T) + sizeof(Slot));
+        return result;
+    }
+};
+
+// FlightTable class
+// Column store of the fields that flight listings filter and sort on, one row per flight
+// in the catalog. Each column is a plain array, so a scan over a million flights reads a
+// few bytes per flight in order instead of chasing pointers into every Flight object.
+// Flights write their changes through to their row; rows are added and removed by Airline
+// with its catalog lock held, removal moves the last row into the gap.
+class FlightTable {
+private:
+    vector<Flight*> flights;
+    vector<int32_t> flightIds;
+    vector<uint8_t> statuses;
+    vector<int32_t> departures; // Minutes after midnight of Day 1
+    vector<uint32_t> origins; // Airport ids of the airline's AirportRegistry
+    vector<uint32_t> destinations;
+    vector<int32_t> prices;
+    vector<uint16_t> freeSeats[CABIN_COUNT];
+
+public:
+    // Adds a row for the flight and returns its index, defined after Flight
+    uint32_t add(Flight* flight);
+
+    // Removes a row, the last row takes its place, defined after Flight
+    void remove(uint32_t row);
+
+    size_t size() const { return flights.size(); }
+    Flight* getFlight(uint32_t row) const { return flights[row]; }
+    int getFlightId(uint32_t row) const { return flightIds[row]; }
+    FlightStatus getStatus(uint32_t row) const { return static_cast<FlightStatus>(statuses[row]); }
+    int getDeparture(uint32_t row) const { return departures[row]; }
+    uint32_t getOrigin(uint32_t row) const { return origins[row]; }
+    uint32_t getDestination(uint32_t row) const { return destinations[row]; }
+    int getPrice(uint32_t row) const { return prices[row]; }
+    int getFreeSeats(uint32_t row, SeatType seatType) const { return freeSeats[static_cast<int>(seatType)][row]; }
+
+    // Write-through from Flight
+    void setStatus(uint32_t row, FlightStatus status) { statuses[row] = static_cast<uint8_t>(status); }
+    void setDeparture(uint32_t row, int departure) { departures[row] = departure; }
+    void setAirports(uint32_t row, uint32_t origin, uint32_t destination) {
+        origins[row] = origin;
+        destinations[row] = destination;
+    }
+    void setPrice(uint32_t row, int price) { prices[row] = price; }
+    void setFreeSeats(uint32_t row, SeatType seatType, int count) { freeSeats[static_cast<int>(seatType)][row] = static_cast<uint16_t>(count); }
+
+    // Rows with the status and at least one free seat in the cabin, in row order
+    // Branch-free: every row is written and the count only advances on a match
+    void selectOpen(FlightStatus status, SeatType seatType, vector<uint32_t>& rows) const {
+        const uint8_t wanted = static_cast<uint8_t>(status);
+        const uint8_t* statusColumn = statuses.data();
+        const uint16_t* seatColumn = freeSeats[static_cast<int>(seatType)].data();
+        rows.resize(flights.size());
+        size_t count = 0;
+        for (size_t i = 0; i < flights.size(); i++) {
+            rows[count] = static_cast<uint32_t>(i);
+            count += (statusColumn[i] == wanted) & (seatColumn[i] != 0);
+        }
+        rows.resize(count);
+    }
+
+    // Rows from origin to destination
+    void selectRoute(uint32_t origin, uint32_t destination, vector<uint32_t>& rows) const {
+        rows.resize(flights.size());
+        size_t count = 0;
+        for (size_t i = 0; i < flights.size(); i++) {
+            rows[count] = static_cast<uint32_t>(i);
+            count += (origins[i] == origin) & (destinations[i] == destination);
+        }
+        rows.resize(count);
+    }
+
+    // Orders rows by departure, then by flight id
+    void sortByDeparture(vector<uint32_t>& rows) const {
+        sort(rows.begin(), rows.end(), [this](uint32_t a, uint32_t b) {
+            return departures[a] != departures[b] ? departures[a] < departures[b] : flightIds[a] < flightIds[b];
+        });
+    }
+
+    // Orders rows by flight id
+    void sortById(vector<uint32_t>& rows) const {
+        sort(rows.begin(), rows.end(), [this](uint32_t a, uint32_t b) { return flightIds[a] < flightIds[b]; });
+    }
+};
+
+// Id of no airport
+const uint32_t NO_AIRPORT = UINT32_MAX;
+
+// True for an IATA style code of three capital letters such as "NYC"
+bool isAirportCode(string_view code) {
+    if (code.size() != 3) return false;
+    for (char c : code) {
+        if (c < 'A' || c > 'Z') return false;
+    }
+    return true;
+}
+
+// Splits "NYC-LON" into its airport codes, returns false unless both are valid and differ
+bool splitRoute(string_view route, string_view& origin, string_view& destination) {
+    size_t dash = route.find('-');
+    if (dash == string_view::npos) return false;
+    origin = route.substr(0, dash);
+    destination = route.substr(dash + 1);
+    return isAirportCode(origin) && isAirportCode(destination) && origin != destination;
+}
+
+// AirportRegistry class
+// Interns airport codes into dense ids starting at 0, ids are never reused
+class AirportRegistry {
+private:
+    vector<string> codes;
+    unordered_map<string, uint32_t> ids;
+
+public:
+    uint32_t intern(string_view code) {
+        auto it = ids.find(string(code));
+        if (it != ids.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(codes.size());
+        codes.emplace_back(code);
+        ids[codes.back()] = id;
+        return id;
+    }
+
+    // Id of a known airport, or NO_AIRPORT
+    uint32_t find(string_view code) const {
+        auto it = ids.find(string(code));
+        return it == ids.end() ? NO_AIRPORT : it->second;
+    }
+
+    const string& getCode(uint32_t id) const {
+        return codes[id];
+    }
+
+    size_t size() const {
+        return codes.size();
+    }
+};
+
+// Key of an (origin, destination) airport pair
+inline uint64_t routeKey(uint32_t origin, uint32_t destination) {
+    return (static_cast<uint64_t>(origin) << 32) | destination;
+}
+
+// RouteGraph class
+// Directed graph of the airports, with an edge wherever at least one flight in the
+// catalog connects two of them. Kept up to date as flights are added, removed or rerouted.
+class RouteGraph {
+public:
+    struct Edge {
+        uint32_t destination;
+        uint32_t flightCount; // Flights in the catalog on this edge
+    };
+
+private:
+    vector<vector<Edge>> adjacency; // Indexed by origin airport id
+
+public:
+    void addFlight(uint32_t origin, uint32_t destination) {
+        if (origin == NO_AIRPORT || destination == NO_AIRPORT) return;
+        if (adjacency.size() <= origin) adjacency.resize(origin + 1);
+        for (Edge& edge : adjacency[origin]) {
+            if (edge.destination == destination) {
+                edge.flightCount++;
+                return;
+            }
+        }
+        adjacency[origin].push_back(Edge{ destination, 1 });
+    }
+
+    void removeFlight(uint32_t origin, uint32_t destination) {
+        if (origin == NO_AIRPORT || origin >= adjacency.size()) return;
+        vector<Edge>& edges = adjacency[origin];
+        for (size_t i = 0; i < edges.size(); i++) {
+            if (edges[i].destination != destination) continue;
+            if (--edges[i].flightCount == 0) {
+                edges[i] = edges.back();
+                edges.pop_back();
+            }
+            return;
+        }
+    }
+
+    // Edges leaving the airport
+    const vector<Edge>& getRoutesFrom(uint32_t origin) const {
+        static const vector<Edge> none;
+        return origin < adjacency.size() ? adjacency[origin] : none;
+    }
+
+    bool hasRoute(uint32_t origin, uint32_t destination) const {
+        for (const Edge& edge : getRoutesFrom(origin)) {
+            if (edge.destination == destination) return true;
+        }
+        return false;
+    }
+};
+
+// ThreadPool class
+// A fixed set of worker threads that run batches of indexed tasks
+class ThreadPool {
+private:
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex lock;
+    condition_variable taskReady;
+    condition_variable taskDone;
+    size_t pending = 0;
+    bool stopping = false;
+
+    void workerLoop() {
+        while (true) {
+            function<void()> task;
+            {
+                unique_lock<mutex> guard(lock);
+                taskReady.wait(guard, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+            {
+                lock_guard<mutex> guard(lock);
+                if (--pending == 0) taskDone.notify_all();
+            }
+        }
+    }
+
+public:
+    // threadCount 0 uses one thread per hardware core
+    ThreadPool(unsigned threadCount = 0) {
+        if (!threadCount) threadCount = max(1u, thread::hardware_concurrency());
+        for (unsigned i = 0; i < threadCount; i++) workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        taskReady.notify_all();
+        for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Runs task(0) .. task(count - 1) on the workers and waits for all of them
+    void run(size_t count, const function<void(size_t)>& task) {
+        if (!count) return;
+        {
+            lock_guard<mutex> guard(lock);
+            for (size_t i = 0; i < count; i++) tasks.push([&task, i] { task(i); });
+            pending += count;
+        }
+        taskReady.notify_all();
+        unique_lock<mutex> guard(lock);
+        taskDone.wait(guard, [this] { return pending == 0; });
+    }
+};
+
+// PricingEngine class 
+
+//calculate the final price of ticket according to provided factors like seasonal factor, event factor and demand factor
+class PricingEngine {
+private:
+    //PricingStrategy* strategy;
+    double seasonalFactor;
+    double eventFactor;
+    double demandFactor;
+
+public:
+
+    PricingEngine(double sf = 1,double ef = 1 , double df = 1) : seasonalFactor(sf),eventFactor(ef),demandFactor(df){}
+	/*If seasonalFactor is non-zero, basePrice is multiplied by seasonalFactor; otherwise, basePrice remains unchanged.
+If eventFactor is non-zero, the intermediate result is further multiplied by eventFactor.
+If demandFactor is non-zero, the result is finally multiplied by demandFactor.
+This ensures that the final price is adjusted according to the provided factors.*/
+  
+    double calculatePrice(double basePrice) const {
+        double ans = (seasonalFactor ? basePrice * seasonalFactor : basePrice);
+        if (eventFactor) ans *= eventFactor;
+        if (demandFactor) ans *= demandFactor;
+        return ans;
+    }
+
+    // Prices count fares at once, out[i] == calculatePrice(basePrices[i]) bit for bit.
+    // A zero factor is skipped by calculatePrice, which is the same as multiplying by 1.0
+    // (exact in IEEE arithmetic), so the factors are resolved once and the loop has no
+    // branches left for the compiler to vectorize. The multiplication order is kept.
+    void calculatePrices(const double* __restrict basePrices, double* __restrict out, size_t count) const {
+        const double seasonal = seasonalFactor ? seasonalFactor : 1.0;
+        const double event = eventFactor ? eventFactor : 1.0;
+        const double demand = demandFactor ? demandFactor : 1.0;
+        // Blocks of four independent lanes vectorize even at -O2, the tail is done one by one
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            out[i] = basePrices[i] * seasonal * event * demand;
+            out[i + 1] = basePrices[i + 1] * seasonal * event * demand;
+            out[i + 2] = basePrices[i + 2] * seasonal * event * demand;
+            out[i + 3] = basePrices[i + 3] * seasonal * event * demand;
+        }
+        for (; i < count; i++) {
+            out[i] = basePrices[i] * seasonal * event * demand;
+        }
+    }
+
+    void calculatePrices(const vector<double>& basePrices, vector<double>& out) const {
+        out.resize(basePrices.size());
+        calculatePrices(basePrices.data(), out.data(), basePrices.size());
+    }
+};
+
+// Pricing factors of one route, a basePrice of 0 keeps the flight's own price
+struct RouteFactors {
+    double basePrice = 0;
+    double demandFactor = 1;
+    double seasonalFactor = 1;
+    double eventFactor = 1;
+
+    PricingEngine engine() const {
+        return PricingEngine(seasonalFactor, eventFactor, demandFactor);
+    }
+};
+
+// Route keyed factors as read from the factor file, never modified once published
+struct RouteFactorTable {
+    uint64_t version = 0; // Set by PricingTable::publish, lets cached fares notice a reload
+    RouteFactors defaults; // Used for routes without their own row ("*" in the file)
+    unordered_map<string, RouteFactors> routes;
+
+    const RouteFactors& lookup(const string& route) const {
+        auto it = routes.find(route);
+        return it == routes.end() ? defaults : it->second;
+    }
+};
+
+const string FACTOR_FILE = "pricing_factors.txt";
+
+// PricingTable class
+// Holds the current RouteFactorTable and swaps in reloaded ones RCU style: readers only
+// bump a counter and load a pointer, a reload publishes the new table with one atomic
+// store and frees the old one after every reader that could still see it has left.
+class PricingTable {
+private:
+    atomic<const RouteFactorTable*> current;
+    atomic<unsigned> epoch{ 0 };
+    atomic<int> readers[2];
+    mutex writerLock; // Serializes publishers only
+    uint64_t nextVersion = 1;
+
+    // Waits until no reader can still hold a table published before this call.
+    // Readers register in the slot of the epoch they saw, flipping twice drains both slots.
+    void synchronize() {
+        for (int flip = 0; flip < 2; flip++) {
+            unsigned old = epoch.fetch_add(1);
+            while (readers[old & 1].load() != 0) this_thread::yield();
+        }
+    }
+
+public:
+    // Pins the table that was current when it was created
+    class ReadGuard {
+    private:
+        PricingTable* owner;
+        unsigned slot;
+        const RouteFactorTable* table;
+
+    public:
+        ReadGuard(PricingTable& owner) : owner(&owner) {
+            slot = owner.epoch.load() & 1;
+            owner.readers[slot].fetch_add(1);
+            table = owner.current.load();
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        ~ReadGuard() {
+            owner->readers[slot].fetch_sub(1);
+        }
+
+        const RouteFactorTable& operator*() const { return *table; }
+        const RouteFactorTable* operator->() const { return table; }
+    };
+
+    PricingTable(RouteFactors defaults = RouteFactors()) {
+        readers[0] = 0;
+        readers[1] = 0;
+        RouteFactorTable* table = new RouteFactorTable();
+        table->defaults = defaults;
+        current = table;
+    }
+
+    PricingTable(const PricingTable&) = delete;
+    PricingTable& operator=(const PricingTable&) = delete;
+
+    ~PricingTable() {
+        delete current.load();
+    }
+
+    // Makes table the current one and frees the previous table once its readers are gone
+    void publish(RouteFactorTable* table) {
+        lock_guard<mutex> guard(writerLock);
+        table->version = nextVersion++;
+        const RouteFactorTable* old = current.exchange(table);
+        synchronize();
+        delete old;
+    }
+
+    // Final fare of a seat on route whose flight costs basePrice
+    double quote(const string& route, double basePrice) {
+        ReadGuard table(*this);
+        const RouteFactors& factors = table->lookup(route);
+        return factors.engine().calculatePrice(factors.basePrice ? factors.basePrice : basePrice);
+    }
+};
+
+// FileWatcher class
+// Polls the modification time of a file and calls onChange on its own thread when it changes
+class FileWatcher {
+private:
+    string path;
+    chrono::milliseconds interval;
+    function<void()> onChange;
+    thread worker;
+    mutex lock;
+    condition_variable wake;
+    bool stopping = false;
+
+    filesystem::file_time_type modifiedTime() {
+        error_code error;
+        filesystem::file_time_type stamp = filesystem::last_write_time(path, error);
+        return error ? filesystem::file_time_type() : stamp;
+    }
+
+    void watch() {
+        filesystem::file_time_type seen = modifiedTime();
+        unique_lock<mutex> guard(lock);
+        while (!wake.wait_for(guard, interval, [this] { return stopping; })) {
+            filesystem::file_time_type stamp = modifiedTime();
+            if (stamp == seen) continue;
+            seen = stamp;
+            guard.unlock();
+            onChange();
+            guard.lock();
+        }
+    }
+
+public:
+    FileWatcher(string path, function<void()> onChange, chrono::milliseconds interval = chrono::milliseconds(500))
+        : path(path), interval(interval), onChange(onChange) {
+        worker = thread(&FileWatcher::watch, this);
+    }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    ~FileWatcher() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+};
+
+// Fields of one schedule row, pointing into the loaded file buffer
+struct ScheduleRow {
+    string_view route;
+    string_view flightState;
+    string_view crewName;
+    string_view crewRole;
+    string_view crewCompliance;
+    string_view crewState;
+};
+
+// Splits "route,state,crewName,crewRole,compliance,crewState" in place
+// Missing trailing fields are left empty, the last field takes the rest of the line
+void parseScheduleRow(string_view line, ScheduleRow& row) {
+    string_view* fields[] = { &row.route, &row.flightState, &row.crewName, &row.crewRole, &row.crewCompliance, &row.crewState };
+    const int fieldCount = 6;
+    for (int i = 0; i < fieldCount; i++) {
+        size_t comma = (i == fieldCount - 1) ? string_view::npos : line.find(',');
+        *fields[i] = line.substr(0, comma);
+        line = (comma == string_view::npos) ? string_view() : line.substr(comma + 1);
+    }
+}
+
+// Calls onRow(row, status) for every schedule line in [data, end)
+// Lines with an unknown flight state go to onError(row) instead
+template <typename RowFn, typename ErrorFn>
+void forEachScheduleRow(const char* data, const char* end, RowFn onRow, ErrorFn onError) {
+    ScheduleRow row;
+    while (data < end) {
+        const char* newline = static_cast<const char*>(memchr(data, '\n', end - data));
+        const char* lineEnd = newline ? newline : end;
+        string_view line(data, lineEnd - data);
+        data = lineEnd + 1;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+
+        parseScheduleRow(line, row);
+        FlightStatus status;
+        if (convertStringToFlightStatus(row.flightState, status)) onRow(row, status);
+        else onError(row);
+    }
+}
+
+// Statistics of the last schedule load
+struct LoadStats {
+    size_t rows = 0;    // Flights/crews created
+    size_t skipped = 0; // Rows rejected (unknown flight state)
+    size_t bytes = 0;
+    double seconds = 0;
+
+    double rowsPerSecond() const {
+        return seconds > 0 ? rows / seconds : 0;
+    }
+};
+
+// Flushes a stdio file and forces it to disk
+bool syncFile(FILE* file) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Moves tempPath over path in one step, so a crash leaves either the old or the new file
+// and never neither. rename only replaces an existing file atomically on POSIX
+bool replaceFile(const string& tempPath, const string& path) {
+#ifdef _WIN32
+    return MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+}
+
+// Kinds of mutation recorded in the journal
+enum class JournalOp : uint8_t {
+    RegisterPassenger,
+    Book,
+    Cancel,
+    Modify,
+    SpecialRequest,
+    AssignCrew,
+    RemoveCrew,
+    Reroute,
+    SetTime,
+    SetStatus,
+    SetPrice,
+    AddFlight,
+    RemoveFlight,
+    // Replace SetTime and AddFlight, which carried the display string and are only replayed
+    SetDeparture,
+    ScheduleFlight,
+    Rebook,
+    // Replaces Modify, which only carried the cabin and is only replayed
+    ModifySeats
+};
+
+const string JOURNAL_FILE = "airline_journal.bin";
+
+// What Journal::replay found in the journal file
+struct ReplayStats {
+    size_t applied = 0; // Records after the snapshot that apply accepted
+    size_t rejected = 0; // Records apply refused, the replayed state has diverged from the journal
+    uint64_t lastSequence = 0; // Sequence of the last intact record
+    uint64_t validBytes = 0; // Length of the intact records at the start of the file
+    bool tornTail = false; // Bytes after them are a record torn by a crash or otherwise damaged
+};
+
+// Encodes the payload of a journal record
+class JournalWriter {
+private:
+    string data;
+
+public:
+    JournalWriter& putU8(uint8_t value) {
+        data.push_back(static_cast<char>(value));
+        return *this;
+    }
+
+    JournalWriter& putI32(int32_t value) {
+        data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        return *this;
+    }
+
+    JournalWriter& putString(const string& text) {
+        putI32(static_cast<int32_t>(text.size()));
+        data += text;
+        return *this;
+    }
+
+    const string& str() const { return data; }
+};
+
+// Decodes the payload of a journal record, ok() turns false on a short payload
+class JournalReader {
+private:
+    string_view data;
+    bool valid = true;
+
+public:
+    JournalReader(string_view data) : data(data) {}
+
+    uint8_t getU8() {
+        if (data.empty()) { valid = false; return 0; }
+        uint8_t value = static_cast<uint8_t>(data[0]);
+        data.remove_prefix(1);
+        return value;
+    }
+
+    int32_t getI32() {
+        int32_t value = 0;
+        if (data.size() < sizeof(value)) { valid = false; return 0; }
+        memcpy(&value, data.data(), sizeof(value));
+        data.remove_prefix(sizeof(value));
+        return value;
+    }
+
+    string getString() {
+        int32_t length = getI32();
+        if (length < 0 || static_cast<size_t>(length) > data.size()) { valid = false; return string(); }
+        string text(data.substr(0, length));
+        data.remove_prefix(length);
+        return text;
+    }
+
+    bool ok() const { return valid; }
+};
+
+// Journal class
+// Append-only log of every mutation, replayed on top of the last snapshot after a restart.
+// Appends only copy the record into a buffer; a flusher thread writes whatever has piled
+// up and makes it durable with one fsync, so concurrent commits share a single sync.
+class Journal {
+private:
+    // Record framing: payload length, checksum of op + payload, sequence number, op
+    struct RecordHeader {
+        uint32_t length;
+        uint32_t checksum;
+        uint64_t sequence;
+        uint8_t op;
+    };
+    static const size_t HEADER_BYTES = 17;
+
+    FILE* file = nullptr;
+    thread flusher;
+    mutex lock;
+    condition_variable workReady;
+    condition_variable durable;
+    string pending;
+    uint64_t nextSequence = 1;
+    uint64_t durableSequence = 0;
+    uint64_t syncCount = 0;
+    bool stopping = false;
+    bool failed = false;
+
+    static uint32_t checksum(uint8_t op, string_view payload) {
+        // FNV-1a, enough to spot a record torn by a crash
+        uint32_t hash = 2166136261u;
+        hash = (hash ^ op) * 16777619u;
+        for (size_t i = 0; i < payload.size(); i++) hash = (hash ^ static_cast<uint8_t>(payload[i])) * 16777619u;
+        return hash;
+    }
+
+    void flushLoop() {
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            workReady.wait(guard, [this] { return stopping || !pending.empty(); });
+            if (pending.empty() && stopping) return;
+            string batch;
+            batch.swap(pending);
+            uint64_t batchEnd = nextSequence - 1;
+            guard.unlock();
+            bool written = fwrite(batch.data(), 1, batch.size(), file) == batch.size() && syncFile(file);
+            guard.lock();
+            if (!written) failed = true;
+            durableSequence = batchEnd;
+            syncCount++;
+            durable.notify_all();
+        }
+    }
+
+public:
+    Journal() {}
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    ~Journal() {
+        close();
+    }
+
+    // Opens the journal for appending, new records are numbered after lastSequence
+    bool open(const string& path, uint64_t lastSequence) {
+        close();
+        file = fopen(path.c_str(), "ab");
+        if (!file) return false;
+        nextSequence = lastSequence + 1;
+        durableSequence = lastSequence;
+        stopping = false;
+        failed = false;
+        flusher = thread(&Journal::flushLoop, this);
+        return true;
+    }
+
+    // Flushes what is pending and closes the file
+    void close() {
+        if (!file) return;
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        workReady.notify_all();
+        flusher.join();
+        fclose(file);
+        file = nullptr;
+    }
+
+    // Empties the journal file, called once a snapshot covers every record in it
+    bool truncate(const string& path) {
+        uint64_t lastSequence = nextSequence - 1;
+        close();
+        FILE* empty = fopen(path.c_str(), "wb");
+        if (!empty) return false;
+        fclose(empty);
+        return open(path, lastSequence);
+    }
+
+    // Buffers a record and returns its sequence number, commit() makes it durable
+    uint64_t append(JournalOp op, const string& payload) {
+        RecordHeader header;
+        header.length = static_cast<uint32_t>(payload.size());
+        header.checksum = checksum(static_cast<uint8_t>(op), payload);
+        header.op = static_cast<uint8_t>(op);
+        lock_guard<mutex> guard(lock);
+        header.sequence = nextSequence++;
+        pending.append(reinterpret_cast<const char*>(&header.length), sizeof(header.length));
+        pending.append(reinterpret_cast<const char*>(&header.checksum), sizeof(header.checksum));
+        pending.append(reinterpret_cast<const char*>(&header.sequence), sizeof(header.sequence));
+        pending.push_back(static_cast<char>(header.op));
+        pending += payload;
+        workReady.notify_one();
+        return header.sequence;
+    }
+
+    // Waits until the record with the given sequence number is on disk (group commit)
+    bool commit(uint64_t sequence) {
+        unique_lock<mutex> guard(lock);
+        durable.wait(guard, [this, sequence] { return durableSequence >= sequence || !file; });
+        return !failed;
+    }
+
+    uint64_t getLastSequence() {
+        lock_guard<mutex> guard(lock);
+        return nextSequence - 1;
+    }
+
+    // Number of fsyncs done so far, lower than the number of records when commits were grouped
+    uint64_t getSyncCount() {
+        lock_guard<mutex> guard(lock);
+        return syncCount;
+    }
+
+    // Calls apply(sequence, op, payload) for every record after afterSequence, stopping at a torn tail
+    // apply returns false for a record it could not apply
+    static ReplayStats replay(const string& path, uint64_t afterSequence, const function<bool(uint64_t, JournalOp, JournalReader&)>& apply) {
+        ReplayStats stats;
+        ifstream in(path, ios::binary);
+        if (!in.is_open()) return stats;
+        string data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        size_t pos = 0;
+        while (data.size() - pos >= HEADER_BYTES) {
+            RecordHeader header;
+            memcpy(&header.length, &data[pos], 4);
+            memcpy(&header.checksum, &data[pos + 4], 4);
+            memcpy(&header.sequence, &data[pos + 8], 8);
+            header.op = static_cast<uint8_t>(data[pos + 16]);
+            if (data.size() - pos - HEADER_BYTES < header.length) break;
+            string_view payload(data.data() + pos + HEADER_BYTES, header.length);
+            if (checksum(header.op, payload) != header.checksum) break;
+            pos += HEADER_BYTES + header.length;
+            stats.lastSequence = header.sequence;
+            if (header.sequence <= afterSequence) continue;
+            JournalReader reader(payload);
+            if (apply(header.sequence, static_cast<JournalOp>(header.op), reader)) stats.applied++;
+            else stats.rejected++;
+        }
+        stats.validBytes = pos;
+        stats.tornTail = pos < data.size();
+        return stats;
+    }
+
+    // Cuts the file back to its first validBytes, so records appended after a torn tail
+    // aren't hidden behind it on the next replay
+    static bool trimTail(const string& path, uint64_t validBytes) {
+        error_code error;
+        filesystem::resize_file(path, validBytes, error);
+        return !error;
+    }
+};
+
+// Binary snapshot layout
+// A header followed by fixed-size record sections and one string pool. Links between
+// objects are stored as indices into the record sections, so loading is a single read
+// followed by direct access to the records without any text parsing.
+const char SNAPSHOT_MAGIC[8] = { 'A', 'R', 'S', 'S', 'N', 'A', 'P', '\0' };
+const uint32_t SNAPSHOT_VERSION = 3;
+const string SNAPSHOT_FILE = "airline_snapshot.bin";
+
+// Offset and length of a string in the string pool
+struct SnapshotString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SnapshotFlight {
+    int32_t id;
+    int32_t price;
+    SnapshotString route;
+    int32_t departure;
+    uint32_t firstCrew; // Into the crew link section
+    uint32_t crewCount;
+    uint32_t transitionCounts[FLIGHT_STATUS_COUNT][FLIGHT_STATUS_COUNT];
+    uint32_t rejectedTransitions;
+    uint8_t status;
+    uint8_t padding[3];
+};
+
+struct SnapshotCrew {
+    int32_t id;
+    SnapshotString name;
+    SnapshotString role;
+    uint8_t state;
+    uint8_t compliance;
+    uint8_t inPool; // 1 if the crew is in the airline's crew pool
+    uint8_t padding;
+};
+
+struct SnapshotPassenger {
+    SnapshotString name;
+    SnapshotString seat;
+    uint32_t firstReservation;
+    uint32_t reservationCount;
+    uint8_t loyaltyEligibility;
+    uint8_t padding[3];
+};
+
+struct SnapshotReservation {
+    SnapshotString seat;
+    SnapshotString specialRequest;
+    uint32_t firstLeg; // Into the leg section
+    uint32_t legCount;
+};
+
+// One flight of a reservation
+struct SnapshotLeg {
+    uint32_t flight; // Index of the flight record
+    int32_t seatNo;
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flightCount;
+    uint32_t crewCount;
+    uint32_t crewLinkCount;
+    uint32_t passengerCount;
+    uint32_t reservationCount;
+    uint32_t legCount;
+    uint32_t padding;
+    uint64_t journalSequence; // Last journal record included in the snapshot
+    uint64_t flightOffset;
+    uint64_t crewOffset;
+    uint64_t crewLinkOffset;
+    uint64_t passengerOffset;
+    uint64_t reservationOffset;
+    uint64_t legOffset;
+    uint64_t stringOffset;
+    uint64_t stringBytes;
+};
+
+// FileHandler class (Facade for handling file operations)
+class FileHandler {
+private:
+    string filePath;
+    string factorPath;
+    LoadStats lastLoad;
+
+    // Reads the whole file into buffer with a single read, returns false if it can't be opened
+    bool readFile(const string& path, string& buffer);
+
+public:
+    FileHandler(string filePath, string factorPath = FACTOR_FILE) : filePath(filePath), factorPath(factorPath) {}
+
+    void readData(Airline& airline);
+
+    // Same result as readData, but the file is split at line boundaries and the
+    // chunks are parsed on a thread pool before being merged in file order
+    // threadCount 0 uses one thread per hardware core
+    void readDataParallel(Airline& airline, unsigned threadCount = 0);
+
+    const LoadStats& getLastLoadStats() const {
+        return lastLoad;
+    }
+
+    // Writes flights, crews, passengers and reservations of the airline to a binary snapshot
+    bool saveSnapshot(const Airline& airline, const string& path);
+
+    // Restores a snapshot written by saveSnapshot into an empty airline
+    bool loadSnapshot(Airline& airline, const string& path);
+
+    // Reads "route,basePrice,demandFactor,seasonalFactor,eventFactor" rows from the factor file and
+    // publishes them as the new table, the route "*" sets the defaults. Returns false if the file can't be read
+    bool loadFactors(PricingTable& table, RouteFactors defaults);
+
+    // Sets the factors of one route in the factor file, a running FileWatcher picks the change up
+    bool updateData(string route, double basePrice, double demandFactor, double seasonalFactor, double eventFactor);
+};
+
+// FlightState interface
+// States carry no per-flight data, so every flight shares one object per status
+// and a transition only changes the FlightStatus tag stored in the Flight.
+class FlightState {
+public:
+    virtual FlightStatus getStatus() const = 0;
+    virtual const char* getName() const = 0;
+
+    // Shared state object for the given status
+    static FlightState* forStatus(FlightStatus status);
+
+    // Transition table, canTransition[from][to]
+    static bool canTransition(FlightStatus from, FlightStatus to) {
+        static const bool table[FLIGHT_STATUS_COUNT][FLIGHT_STATUS_COUNT] = {
+            // to: Scheduled, Delayed, Cancelled
+            { true,  true,  true  }, // from Scheduled
+            { true,  true,  true  }, // from Delayed
+            { true,  false, true  }, // from Cancelled (has to be rescheduled before it can be delayed)
+        };
+        return table[static_cast<int>(from)][static_cast<int>(to)];
+    }
+};
+
+// ScheduledState concrete state
+class ScheduledState : public FlightState {
+public:
+    FlightStatus getStatus() const override { return FlightStatus::Scheduled; }
+    const char* getName() const override { return "Scheduled"; }
+};
+
+// CancelledState concrete state
+class CancelledState : public FlightState {
+public:
+    FlightStatus getStatus() const override { return FlightStatus::Cancelled; }
+    const char* getName() const override { return "Cancelled"; }
+};
+
+// DelayedState concrete state
+class DelayedState : public FlightState {
+public:
+    FlightStatus getStatus() const override { return FlightStatus::Delayed; }
+    const char* getName() const override { return "Delayed"; }
+};
+
+FlightState* FlightState::forStatus(FlightStatus status) {
+    static ScheduledState scheduled;
+    static DelayedState delayed;
+    static CancelledState cancelled;
+    switch (status) {
+    case FlightStatus::Delayed:
+        return &delayed;
+    case FlightStatus::Cancelled:
+        return &cancelled;
+    default:
+        return &scheduled;
+    }
+}
+
+// Function to convert a status string ("Scheduled", "Delayed", "Cancelled") to FlightStatus
+// Returns false if the string is not a known status
+bool convertStringToFlightStatus(string_view text, FlightStatus& status) {
+    for (int i = 0; i < FLIGHT_STATUS_COUNT; i++) {
+        if (text == FlightState::forStatus(static_cast<FlightStatus>(i))->getName()) {
+            status = static_cast<FlightStatus>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Kinds of flight change that people on board are told about
+enum class NoticeKind : uint8_t {
+    Status,
+    Retime,
+    Reroute
+};
+
+// One change to a flight, published by Airline and delivered by NotificationBus
+struct FlightNotice {
+    NoticeKind kind = NoticeKind::Status;
+    int flightId = 0;
+    string route; // Route after the change
+    FlightStatus from = FlightStatus::Scheduled; // Status notices
+    FlightStatus to = FlightStatus::Scheduled;
+    int oldDeparture = 0; // Retime notices
+    int newDeparture = 0;
+};
+
+// Text of a notice, e.g. "flight 4 (NYC-LON) is now Delayed", defined with the FlightState classes
+string describeNotice(const FlightNotice& notice);
+
+string describeNotice(const FlightNotice& notice) {
+    string text = "flight " + to_string(notice.flightId) + " (" + notice.route + ")";
+    switch (notice.kind) {
+    case NoticeKind::Status:
+        return text + " is now " + FlightState::forStatus(notice.to)->getName() + ", was " + FlightState::forStatus(notice.from)->getName();
+    case NoticeKind::Retime:
+        return text + " now departs at " + formatFlightTime(notice.newDeparture) + " instead of " + formatFlightTime(notice.oldDeparture);
+    case NoticeKind::Reroute:
+        return text + " has been rerouted";
+    }
+    return text;
+}
+
+// Observer interface
+// update runs on a NotificationBus worker, so the notices wait in an inbox with its own
+// lock until the menu takes them
+class Observer {
+private:
+    mutex inboxLock;
+    vector<string> inbox;
+
+protected:
+    void deliver(string message) {
+        lock_guard<mutex> guard(inboxLock);
+        inbox.push_back(std::move(message));
+    }
+
+public:
+    virtual ~Observer() {}
+
+    virtual void update(const FlightNotice& notice) = 0;
+
+    // Moves the notices delivered since the last call to the end of out
+    void takeNotices(vector<string>& out) {
+        lock_guard<mutex> guard(inboxLock);
+        out.insert(out.end(), make_move_iterator(inbox.begin()), make_move_iterator(inbox.end()));
+        inbox.clear();
+    }
+
+    // Prints and clears the notices delivered since the last call
+    void printNotices(ostream& out) {
+        vector<string> notices;
+        takeNotices(notices);
+        for (const string& notice : notices) out << "[Notice] " << notice << "\n";
+    }
+};
+
+// PassengerObserver concrete observer
+class PassengerObserver : public Observer {
+public:
+    void update(const FlightNotice& notice) override {
+        deliver("Your " + describeNotice(notice));
+    }
+};
+
+// CrewObserver concrete observer, also used by the head of operations to watch every flight
+class CrewObserver : public Observer {
+public:
+    void update(const FlightNotice& notice) override {
+        deliver("Duty update: " + describeNotice(notice));
+    }
+};
+
+// Position of a crew in a CrewPool, maintained by the pool
+struct CrewPoolSlot {
+    CrewPool* pool = nullptr; // nullptr while the crew is in no pool
+    uint32_t index = 0; // In the pool's list of every member
+    uint32_t bucket = 0;
+    uint32_t bucketIndex = 0; // In that bucket's list
+};
+
+// CrewPool class
+// The airline's pool of crew, kept as one list of every member plus one bucket per role,
+// state and compliance, so "an Available compliant CoPilot" is the back of one bucket.
+// Each crew remembers its slots, and removal moves the last entry of a list into the gap,
+// so adding, removing and re-filing a crew are O(1) whatever the pool size. Crews re-file
+// themselves when their role, state or compliance changes. Changed by Airline with its
+// catalog lock held; removal reorders getCrews().
+class CrewPool {
+private:
+    // Roles that are not a CrewRole share the last group of buckets
+    static const int ROLE_KEY_COUNT = CREW_ROLE_COUNT + 1;
+    static const int STATE_COUNT = 2;
+    static const int BUCKET_COUNT = ROLE_KEY_COUNT * STATE_COUNT * 2;
+
+    vector<Crew*> members;
+    vector<Crew*> buckets[BUCKET_COUNT];
+
+    static uint32_t bucketOf(int roleKey, CrewState state, bool compliance) {
+        return static_cast<uint32_t>((roleKey * STATE_COUNT + static_cast<int>(state)) * 2 + (compliance ? 1 : 0));
+    }
+
+    // Bucket of the crew's current role, state and compliance, defined after Crew
+    static uint32_t bucketOf(const Crew* crew);
+
+    // Adds the crew to and removes it from its bucket, defined after Crew
+    void file(Crew* crew);
+    void unfile(Crew* crew);
+
+public:
+    // Defined after Crew; add ignores a crew that is already in a pool
+    void add(Crew* crew);
+    // Returns false if the crew is not in this pool
+    bool remove(Crew* crew);
+    bool contains(const Crew* crew) const;
+    // Moves the crew to the bucket of its current role, state and compliance
+    void reindex(Crew* crew);
+
+    // Any crew in the bucket, or nullptr, O(1)
+    Crew* find(CrewRole role, CrewState state, bool compliance) const {
+        const vector<Crew*>& bucket = buckets[bucketOf(static_cast<int>(role), state, compliance)];
+        return bucket.empty() ? nullptr : bucket.back();
+    }
+
+    // Every crew of the bucket, in no particular order
+    const vector<Crew*>& getCrews(CrewRole role, CrewState state, bool compliance) const {
+        return buckets[bucketOf(static_cast<int>(role), state, compliance)];
+    }
+
+    const vector<Crew*>& getCrews() const {
+        return members;
+    }
+
+    size_t size() const {
+        return members.size();
+    }
+
+    void reserve(size_t count) {
+        members.reserve(count);
+    }
+};
+
+// Airline class
+class Airline {
+private:
+    string name;
+    vector<Flight*> flights;
+    CrewPool crews;
+    vector<Passenger*> passengers;
+
+    // Storage of the flights, crews, passengers and reservations, owned by the airline
+    ObjectPool<Flight> flightStore;
+    ObjectPool<Crew> crewStore;
+    ObjectPool<Passenger> passengerStore;
+    ObjectPool<Reservation> reservationStore;
+    mutex reservationLock; // Sessions create and release reservations concurrently
+    unordered_map<string, Passenger*> passengersByName;
+
+    // Crew by id, every crew made by createCrew is registered here
+    int nextCrewId = 1;
+    unordered_map<int, Crew*> crewsById;
+
+    // Journal of mutations, nullptr while loading or replaying
+    Journal* journal = nullptr;
+    bool waitForCommits = true; // false when the caller groups commits with syncJournal
+
+    // Bus that tells passengers and crew about flight changes, nullptr while loading or replaying
+    NotificationBus* notificationBus = nullptr;
+
+    // Publishes the notice if a bus is attached, called after the locks are released
+    void notify(FlightNotice notice);
+    atomic<uint64_t> journalSequence{ 0 }; // Last journal record reflected in this airline
+
+    // Appends a record to the journal (if any) while the caller still holds its locks,
+    // so records of one flight or passenger are in the order they were applied
+    // Returns the sequence number to commit, 0 when nothing was journaled
+    uint64_t record(JournalOp op, const JournalWriter& payload) {
+        if (!journal) return 0;
+        uint64_t sequence = journal->append(op, payload.str());
+        uint64_t last = journalSequence.load();
+        while (last < sequence && !journalSequence.compare_exchange_weak(last, sequence)) {}
+        return sequence;
+    }
+
+    // Waits until the record is durable, called after the locks are released so
+    // concurrent sessions share one sync
+    void commit(uint64_t sequence) {
+        if (journal && sequence && waitForCommits) journal->commit(sequence);
+    }
+
+    // Concurrency: sessions (booking, cancelling, quoting) hold catalogLock shared, then
+    // the passenger's lock, then the lock of each flight they touch, in flight id order.
+    // Changes to the catalog, crews or flight details hold catalogLock exclusively.
+    mutable shared_mutex catalogLock;
+    mutable mutex passengerLock; // Guards the passenger registry and its storage
+
+    // Locks every distinct flight of the list in id order
+    static vector<unique_lock<mutex>> lockFlights(vector<Flight*> legs);
+
+    // Catalog insert shared by addFlight and scheduleFlight, caller holds catalogLock
+    void insertFlight(Flight* flight);
+
+    // Takes a flight out of the catalog and frees its crew, caller holds catalogLock
+    void dropFlight(Flight* flight);
+
+    // Indexed catalog of the flights
+    int nextFlightId = 1;
+    unordered_map<int, Flight*> flightsById;
+    unordered_map<uint64_t, vector<Flight*>> flightsByRoute; // Keyed by routeKey(origin, destination)
+    map<pair<int, int>, Flight*> flightsByDeparture; // Keyed by (departure, flight id)
+    AirportRegistry airports;
+    RouteGraph routeGraph;
+
+    // Interns the airports of the flight's route; a route that isn't "AAA-BBB" (only possible in
+    // old data) is kept apart by interning the whole text as its origin with no destination
+    void resolveAirports(Flight* flight);
+    map<int, Flight*> flightsByStatus[FLIGHT_STATUS_COUNT]; // Ordered by flight id for listing
+    FlightTable flightTable; // Columns of the catalog for bulk scans
+
+    void indexFlight(Flight* flight);
+    void unindexFlight(Flight* flight);
+public:
+    Airline(string name) : name(name) {}
+
+    // Getter for name, name
+    string getName() const {
+        return name;
+    }
+
+    // Getter for flights , return flights
+    //Returns a constant reference to the vector of flights pointers.
+    const vector<Flight*>& getFlights() const {
+        return flights;
+    }
+
+    // Getter for crews, return crew
+    //Returns a constant reference to the vector of crews pointers.
+    const vector<Crew*>& getCrews() const {
+        return crews.getCrews();
+    }
+
+    // The crew pool indexed by role, state and compliance
+    const CrewPool& getCrewPool() const {
+        return crews;
+    }
+
+    // Getter for passengers return passenger
+    //Returns a constant reference to the vector of passengers pointers.
+    const vector<Passenger*>& getPassengers() const {
+        return passengers;
+    }
+
+    // Builds a flight in the airline's storage, addFlight puts it in the catalog
+    template <typename... Args>
+    Flight* createFlight(Args&&... args);
+
+    // Builds a crew in the airline's storage, addCrew puts it in the pool
+    template <typename... Args>
+    Crew* createCrew(Args&&... args);
+
+    // Builds a passenger in the airline's storage, addPassenger registers it
+    Passenger* createPassenger(string name);
+
+    // Registers the passenger so it can be found by name and is part of snapshots
+    void addPassenger(Passenger* passenger);
+
+    // Returns the registered passenger with the given name, or nullptr
+    Passenger* findPassenger(const string& name) const {
+        lock_guard<mutex> guard(passengerLock);
+        auto it = passengersByName.find(name);
+        return it == passengersByName.end() ? nullptr : it->second;
+    }
+
+    // Returns the passenger with the given name, creating and registering it if needed
+    Passenger* registerPassenger(const string& name);
+
+    // Builds a reservation in the airline's storage, releaseReservation gives the slot back
+    template <typename... Args>
+    Reservation* createReservation(Args&&... args);
+
+    void releaseReservation(Reservation* reservation);
+
+    // Handles stay safe to keep after the flight is removed, getFlight then returns nullptr
+    PoolHandle getFlightHandle(Flight* flight) {
+        shared_lock<shared_mutex> guard(catalogLock);
+        return flightStore.handleOf(flight);
+    }
+
+    Flight* getFlight(PoolHandle handle) const {
+        shared_lock<shared_mutex> guard(catalogLock);
+        return flightStore.get(handle);
+    }
+
+    // Prints live objects, reusable slots and bytes held by each pool
+    void printMemoryUsage(ostream& out);
+
+    // Pre-sizes the storage for a bulk load so it lands in one contiguous block
+    void reserveStorage(size_t flightCount, size_t crewCount) {
+        flightStore.reserve(flightCount);
+        crewStore.reserve(crewCount);
+        flights.reserve(flights.size() + flightCount);
+        crews.reserve(crews.size() + crewCount);
+    }
+
+    // Gives the flight an id (if it has none) and adds it to the catalog
+    void addFlight(Flight* flight);
+
+    // Removes the flight from the catalog and releases it, refused while passengers are booked on it
+    bool removeFlight(Flight* flight);
+
+    // Returns the flight with the given id, or nullptr
+    Flight* getFlightById(int id) const {
+        shared_lock<shared_mutex> guard(catalogLock);
+        auto it = flightsById.find(id);
+        return it == flightsById.end() ? nullptr : it->second;
+    }
+
+    // Returns every flight on the route (e.g. "NYC-LON")
+    const vector<Flight*>& getFlightsByRoute(const string& route) const {
+        string_view origin, destination;
+        if (!splitRoute(route, origin, destination)) return getFlightsByRoute(airports.find(route), NO_AIRPORT);
+        return getFlightsByRoute(airports.find(origin), airports.find(destination));
+    }
+
+    // Returns every flight between two interned airports
+    const vector<Flight*>& getFlightsByRoute(uint32_t origin, uint32_t destination) const {
+        static const vector<Flight*> none;
+        if (origin == NO_AIRPORT) return none;
+        auto it = flightsByRoute.find(routeKey(origin, destination));
+        return it == flightsByRoute.end() ? none : it->second;
+    }
+
+    const AirportRegistry& getAirports() const {
+        return airports;
+    }
+
+    const RouteGraph& getRouteGraph() const {
+        return routeGraph;
+    }
+
+    // Holds the catalog steady for a reader that walks it through the getters above
+    shared_lock<shared_mutex> readCatalog() const {
+        return shared_lock<shared_mutex>(catalogLock);
+    }
+
+    // Column view of the catalog for bulk scans, read with no sessions running
+    const FlightTable& getFlightTable() const {
+        return flightTable;
+    }
+
+    // Flights with the status and a free seat in the cabin, by flight id, found with one column scan
+    void findOpenFlights(FlightStatus status, SeatType seatType, vector<Flight*>& found) const;
+
+    // Fills found with the flights departing at or after from and before to, earliest first
+    void findFlightsDeparting(int from, int to, vector<Flight*>& found) const;
+
+    // Start of the first slot at or after the given time in which no flight departs
+    int findFreeSlot(int after) const;
+
+    // Returns every flight with the given status keyed by flight id
+    const map<int, Flight*>& getFlightsByStatus(FlightStatus status) const {
+        return flightsByStatus[static_cast<int>(status)];
+    }
+
+    // Moves the flight to the given status and keeps the status index up to date
+    // Returns false if the transition table does not allow it
+    bool setFlightStatus(Flight* flight, FlightStatus status);
+
+    // Changes the route of the flight and keeps the route index up to date
+    // Returns false if newRoute is not two airport codes such as "NYC-LON"
+    bool rerouteFlight(Flight* flight, string newRoute);
+
+
+    // Crew pool changes, called while loading or with catalogLock held
+    void addCrew(Crew* crew) {
+        crews.add(crew);
+    }
+
+    // Takes the crew out of the pool in O(1), its duties stay; the last crew of
+    // getCrews() takes its place
+    bool removeCrew(Crew* crew) {
+        return crews.remove(crew);
+    }
+
+    // Returns the crew with the given id, or nullptr
+    Crew* getCrewById(int id) const {
+        auto it = crewsById.find(id);
+        return it == crewsById.end() ? nullptr : it->second;
+    }
+
+    // Gives a crew the id it had when a snapshot was taken
+    void restoreCrewId(Crew* crew, int id);
+
+    // Prices every cabin of every flight in one batch
+    // grid[i * CABIN_COUNT + cabin] is the fare of getFlights()[i] in that cabin
+    void priceFareGrid(const PricingEngine& engine, vector<double>& grid) const;
+
+    // Same layout, priced with the factors of each flight's route and the demand of each cabin,
+    // every entry equals the flight's quoteFare for that cabin
+    void priceFareGrid(PricingTable& pricing, vector<double>& grid) const;
+
+    // Starts recording every mutation in the journal. With waitForEachCommit false operations
+    // return before their record is durable and syncJournal makes everything so far durable.
+    void setJournal(Journal* newJournal, bool waitForEachCommit = true) {
+        journal = newJournal;
+        waitForCommits = waitForEachCommit;
+    }
+
+    // Starts publishing status, time and route changes of flights to the bus
+    void setNotificationBus(NotificationBus* bus) {
+        notificationBus = bus;
+    }
+
+    // Fills found with the observers of everyone on board the flight (its crew and passengers),
+    // each once; empty if the flight left the catalog
+    void collectSubscribers(int flightId, vector<Observer*>& found) const;
+
+    uint64_t getJournalSequence() const {
+        return journalSequence.load();
+    }
+
+    void setJournalSequence(uint64_t sequence) {
+        journalSequence = sequence;
+    }
+
+    // Re-applies one journal record, returns false if it does not match the current state
+    bool applyJournalRecord(uint64_t sequence, JournalOp op, JournalReader& reader);
+
+    // Journaled operations used by the menus, safe to call from concurrent sessions
+    Reservation* bookFlight(Passenger* passenger, Flight* flight, SeatType seatType);
+    void cancelReservation(Passenger* passenger, int idx);
+    bool modifyReservation(Passenger* passenger, int idx, SeatType seatType);
+    void setSpecialRequest(Passenger* passenger, int idx, string request);
+    void removeCrewFromFlight(Flight* flight, int idx);
+    void setFlightTime(Flight* flight, int departure);
+    void setFlightPrice(Flight* flight, int newPrice);
+    // Returns nullptr if route is not two airport codes such as "NYC-LON"
+    Flight* scheduleFlight(string route, int departure);
+
+    // Moves the reservation onto new legs in the same cabin, giving up its old seats. Returns
+    // false, changing nothing, if a leg is not Scheduled or has no free seat left. With
+    // durable false the change is journaled but not waited for, see syncJournal.
+    bool rebookReservation(Passenger* passenger, Reservation* reservation, const vector<Flight*>& legs, bool durable = true);
+
+    // Waits until every journaled change so far is durable
+    void syncJournal() {
+        uint64_t sequence = journalSequence.load();
+        if (journal && sequence) journal->commit(sequence);
+    }
+
+    // Flight::quoteFare under the catalog lock, for use from concurrent sessions
+    double quoteFare(Flight* flight, SeatType seatType, PricingTable& pricing) const;
+
+    // Puts the crew on the flight unless it clashes with the crew's other duties,
+    // returns DutyConflict::None if the crew was assigned
+    DutyConflict assignCrewToFlight(Flight* flight, Crew* crew);
+
+    // Fills found with the duty conflicts of the crew of the flight, e.g. after it was retimed
+    void handleScheduleConflicts(Flight* flight, vector<DutyViolation>& found) const;
+
+    // Checks every crew duty in the catalog, see validateRoster
+    void validateRoster(vector<DutyViolation>& found) const;
+
+    // Assigns a planned roster of (crew, flight) duties in one journaled batch, skipping any
+    // duty that no longer fits. Returns how many were assigned.
+    size_t applyRoster(const vector<pair<Crew*, Flight*>>& roster);
+};
+
+// NotificationBus class
+// Fans flight notices out to the passengers and crew on board. Operators publish onto a
+// lock-free multi-producer single-consumer list: a publish is one allocation and one
+// compare-and-swap, so delaying a full flight costs the operator thread the same as an
+// empty one. A dispatcher thread takes everything published so far in one exchange, looks
+// up who is on board each flight, and delivers the batch on a ThreadPool. Deliveries are
+// grouped by observer, so every observer gets its notices in the order they were published.
+class NotificationBus {
+private:
+    struct Node {
+        FlightNotice notice;
+        Node* next;
+    };
+
+    static const size_t DELIVERY_CHUNK = 256; // Deliveries per worker task
+
+    const Airline& airline;
+    atomic<Node*> head{ nullptr }; // Newest notice first
+    ThreadPool workers;
+
+    mutex watchLock;
+    vector<Observer*> watchers; // Get every notice of every flight
+
+    atomic<uint64_t> published{ 0 };
+    atomic<uint64_t> processed{ 0 };
+    atomic<uint64_t> delivered{ 0 };
+    atomic<uint64_t> batches{ 0 };
+
+    mutex wakeLock;
+    condition_variable wake; // Signalled when the list stops being empty, or on shutdown
+    condition_variable idle; // Signalled after every batch
+    bool stopping = false;
+    thread dispatcher; // Last, so everything above exists before it starts
+
+    void dispatchLoop() {
+        vector<FlightNotice> batch;
+        vector<Observer*> subscribers;
+        vector<pair<Observer*, uint32_t>> deliveries; // (observer, index in batch)
+        vector<size_t> chunkStarts;
+        while (true) {
+            Node* taken;
+            {
+                unique_lock<mutex> guard(wakeLock);
+                wake.wait(guard, [this] { return stopping || head.load(memory_order_acquire) != nullptr; });
+                taken = head.exchange(nullptr, memory_order_acquire);
+                if (!taken) return;
+            }
+            // The list is newest first, the batch goes out in publish order
+            batch.clear();
+            while (taken) {
+                batch.push_back(std::move(taken->notice));
+                Node* next = taken->next;
+                delete taken;
+                taken = next;
+            }
+            reverse(batch.begin(), batch.end());
+
+            deliveries.clear();
+            {
+                lock_guard<mutex> guard(watchLock);
+                for (uint32_t i = 0; i < batch.size(); i++) {
+                    for (Observer* watcher : watchers) deliveries.push_back({ watcher, i });
+                }
+            }
+            for (uint32_t i = 0; i < batch.size(); i++) {
+                airline.collectSubscribers(batch[i].flightId, subscribers);
+                for (Observer* subscriber : subscribers) deliveries.push_back({ subscriber, i });
+            }
+            stable_sort(deliveries.begin(), deliveries.end(), [](const pair<Observer*, uint32_t>& a, const pair<Observer*, uint32_t>& b) {
+                return a.first < b.first;
+            });
+            // Chunks end on an observer boundary so no observer is served by two workers
+            chunkStarts.clear();
+            for (size_t d = 0; d < deliveries.size(); d++) {
+                if (chunkStarts.empty() || (d - chunkStarts.back() >= DELIVERY_CHUNK && deliveries[d].first != deliveries[d - 1].first)) chunkStarts.push_back(d);
+            }
+            chunkStarts.push_back(deliveries.size());
+            workers.run(chunkStarts.size() - 1, [&](size_t chunk) {
+                for (size_t d = chunkStarts[chunk]; d < chunkStarts[chunk + 1]; d++) deliveries[d].first->update(batch[deliveries[d].second]);
+            });
+
+            delivered += deliveries.size();
+            batches++;
+            {
+                lock_guard<mutex> guard(wakeLock);
+                processed += batch.size();
+            }
+            idle.notify_all();
+        }
+    }
+
+public:
+    // threadCount 0 delivers on one thread per hardware core
+    NotificationBus(const Airline& airline, unsigned threadCount = 0)
+        : airline(airline), workers(threadCount), dispatcher(&NotificationBus::dispatchLoop, this) {}
+
+    NotificationBus(const NotificationBus&) = delete;
+    NotificationBus& operator=(const NotificationBus&) = delete;
+
+    // Delivers whatever is still queued, then stops
+    ~NotificationBus() {
+        {
+            lock_guard<mutex> guard(wakeLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        dispatcher.join();
+    }
+
+    // Queues the notice and returns without waiting for any delivery, safe from any thread
+    void publish(FlightNotice notice) {
+        Node* node = new Node{ std::move(notice), nullptr };
+        published++;
+        // The dispatcher may take and free the node as soon as it is in, so only previous is read after
+        Node* previous = head.load(memory_order_relaxed);
+        do {
+            node->next = previous;
+        } while (!head.compare_exchange_weak(previous, node, memory_order_release, memory_order_relaxed));
+        // Only the publish that finds the list empty has to wake the dispatcher
+        if (!previous) {
+            lock_guard<mutex> guard(wakeLock);
+            wake.notify_one();
+        }
+    }
+
+    // Waits until everything published so far has been delivered
+    void flush() {
+        unique_lock<mutex> guard(wakeLock);
+        idle.wait(guard, [this] { return processed.load() == published.load(); });
+    }
+
+    // The observer gets every notice until unwatch
+    void watch(Observer* observer) {
+        lock_guard<mutex> guard(watchLock);
+        watchers.push_back(observer);
+    }
+
+    // Returns once no delivery to the observer is left in flight, so it can be deleted
+    void unwatch(Observer* observer) {
+        {
+            lock_guard<mutex> guard(watchLock);
+            watchers.erase(remove(watchers.begin(), watchers.end(), observer), watchers.end());
+        }
+        flush();
+    }
+
+    uint64_t getPublished() const { return published.load(); }
+    uint64_t getDelivered() const { return delivered.load(); }
+    uint64_t getBatches() const { return batches.load(); }
+};
+
+void Airline::notify(FlightNotice notice) {
+    if (notificationBus) notificationBus->publish(std::move(notice));
+}
+
+// Flight class with state pattern integration
+class Flight {
+private:
+    int price;
+    string route;
+    vector<Passenger*> passengers;
+    vector<Crew*> crew;
+    FlightStatus status = FlightStatus::Scheduled;
+    int departure; // Minutes after midnight of Day 1
+    SeatMap seats; // Per-cabin seat inventory
+    int id = 0; // Assigned by Airline::addFlight
+    uint32_t transitionCounts[FLIGHT_STATUS_COUNT][FLIGHT_STATUS_COUNT] = {};
+    uint32_t rejectedTransitions = 0;
+
+    // Bumped whenever something a fare depends on changes (seats, price, route). A seat claim
+    // bumps it straight away, so no quote after the claim is served under the old version
+    atomic<uint32_t> fareVersion{ 0 };
+    // Last quoted fare per cabin, valid while both versions still match. Quotes don't take the
+    // flight's lock: sequence is odd while a quote is being stored and readers retry on a change
+    struct FareQuote {
+        atomic<uint32_t> sequence{ 0 };
+        atomic<uint64_t> tableVersion{ UINT64_MAX };
+        atomic<uint32_t> fareVersion{ 0 };
+        atomic<double> fare{ 0 };
+    };
+    FareQuote quotes[CABIN_COUNT];
+
+    // Guards the seats and passengers once sessions run concurrently
+    mutex seatLock;
+
+    // Row of this flight in the airline's FlightTable, nullptr while not in a catalog
+    FlightTable* table = nullptr;
+    uint32_t tableRow = 0;
+
+    // Interned airports of the route, set by Airline when the flight enters the catalog
+    uint32_t origin = NO_AIRPORT;
+    uint32_t destination = NO_AIRPORT;
+
+    // O(1) refresh after a seat of the cabin changed hands
+    void updateDemand(SeatType seatType) {
+        fareVersion++;
+        if (table) table->setFreeSeats(tableRow, seatType, seats.freeSeats(seatType));
+    }
+
+public:
+    Flight(string route , int departure = 60,int price = 100) : route(route), departure(departure),price(price) {}
+
+    int getId() const {
+        return id;
+    }
+
+    void setId(int id) {
+        this->id = id;
+    }
+
+    void setPrice(int price) {
+        this->price = price;
+        fareVersion++;
+        if (table) table->setPrice(tableRow, price);
+    }
+
+    uint32_t getTableRow() const {
+        return tableRow;
+    }
+
+    uint32_t getOrigin() const {
+        return origin;
+    }
+
+    uint32_t getDestination() const {
+        return destination;
+    }
+
+    void setAirports(uint32_t newOrigin, uint32_t newDestination) {
+        origin = newOrigin;
+        destination = newDestination;
+        if (table) table->setAirports(tableRow, origin, destination);
+    }
+
+    // Called by FlightTable when the flight gets or moves to a row (nullptr when it leaves)
+    void setTableRow(FlightTable* newTable, uint32_t row) {
+        table = newTable;
+        tableRow = row;
+    }
+
+    // Demand pricing: the multiplier grows with the cabin's load factor, read from the atomic seat counts
+    double getDemandMultiplier(SeatType seatType) const {
+        double load = seats.capacity(seatType) ? static_cast<double>(seats.bookedSeats(seatType)) / seats.capacity(seatType) : 0;
+        return 1 + DEMAND_SENSITIVITY * load;
+    }
+
+    // Lock held while the seats or passengers of the flight change
+    // makeReservation, cancelReservation and restoreReservation expect the caller to hold it
+    mutex& getLock() {
+        return seatLock;
+    }
+
+    // Fare of a seat in the cabin: route factors, cabin surcharge and current demand.
+    // Cached until the seats, price or route of the flight change or the factors are reloaded
+    // Never waits for the flight's lock, so quotes go ahead while the flight is being booked
+    double quoteFare(SeatType seatType, PricingTable& pricing) {
+        PricingTable::ReadGuard table(pricing);
+        FareQuote& quote = quotes[static_cast<int>(seatType)];
+        // Read the version before the seats, so a fare priced on newer seats is at worst recomputed
+        uint32_t version = fareVersion.load();
+        uint32_t before = quote.sequence.load(memory_order_acquire);
+        if (!(before & 1)) {
+            uint64_t cachedTable = quote.tableVersion.load(memory_order_relaxed);
+            uint32_t cachedVersion = quote.fareVersion.load(memory_order_relaxed);
+            double cachedFare = quote.fare.load(memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            if (quote.sequence.load(memory_order_relaxed) == before && cachedTable == table->version && cachedVersion == version) return cachedFare;
+        }
+        const RouteFactors& factors = table->lookup(route);
+        double base = (factors.basePrice ? factors.basePrice : price) + CABIN_SURCHARGE[static_cast<int>(seatType)];
+        double fare = factors.engine().calculatePrice(base) * getDemandMultiplier(seatType);
+        // Store it unless another quote is storing one right now
+        if (!(before & 1) && quote.sequence.compare_exchange_strong(before, before + 1, memory_order_acquire)) {
+            atomic_thread_fence(memory_order_release);
+            quote.tableVersion.store(table->version, memory_order_relaxed);
+            quote.fareVersion.store(version, memory_order_relaxed);
+            quote.fare.store(fare, memory_order_relaxed);
+            quote.sequence.store(before + 2, memory_order_release);
+        }
+        return fare;
+    }
+
+    int getPrice() {
+        return price;
+    }
+
+    // Getter for route
+    string getRoute() const {
+        return route;
+    }
+
+    // Getter for passengers
+    const vector<Passenger*>& getPassengers() const {
+        return passengers;
+    }
+
+    // Getter for crew
+    vector<Crew*>& getCrew() {
+        return crew;
+    }
+
+    void setRoute(string s) {
+        route = s;
+    }
+
+    // Getter for the state object of the current status
+    FlightState* getCurrentState() const {
+        return FlightState::forStatus(status);
+    }
+
+    FlightStatus getStatus() const {
+        return status;
+    }
+
+    // Sets the status without going through the transition table (used when loading data)
+    void setStatus(FlightStatus newStatus) {
+        status = newStatus;
+        if (table) table->setStatus(tableRow, status);
+    }
+
+    // Moves the flight to a new status if the transition table allows it
+    bool transitionTo(FlightStatus newStatus) {
+        if (!FlightState::canTransition(status, newStatus)) {
+            rejectedTransitions++;
+            return false;
+        }
+        transitionCounts[static_cast<int>(status)][static_cast<int>(newStatus)]++;
+        status = newStatus;
+        if (table) table->setStatus(tableRow, status);
+        return true;
+    }
+
+    // Number of transitions this flight made from one status to another
+    uint32_t getTransitionCount(FlightStatus from, FlightStatus to) const {
+        return transitionCounts[static_cast<int>(from)][static_cast<int>(to)];
+    }
+
+    // Number of transitions this flight made in total
+    uint32_t getTotalTransitions() const {
+        uint32_t total = 0;
+        for (int i = 0; i < FLIGHT_STATUS_COUNT; i++)
+            for (int j = 0; j < FLIGHT_STATUS_COUNT; j++) total += transitionCounts[i][j];
+        return total;
+    }
+
+    // Number of transitions refused by the transition table
+    uint32_t getRejectedTransitions() const {
+        return rejectedTransitions;
+    }
+
+    // Restores the transition counters (used when loading a snapshot)
+    void restoreTransitionCounts(const uint32_t counts[FLIGHT_STATUS_COUNT][FLIGHT_STATUS_COUNT], uint32_t rejected) {
+        memcpy(transitionCounts, counts, sizeof(transitionCounts));
+        rejectedTransitions = rejected;
+    }
+
+    // Puts a passenger back on a specific seat (used when loading a snapshot)
+    bool restoreReservation(Passenger* passenger, SeatType seatType, int seatNo) {
+        if (!seats.reserveSeat(seatType, seatNo)) return false;
+        passengers.push_back(passenger);
+        updateDemand(seatType);
+        return true;
+    }
+
+    // Departure for display, e.g. "5 pm, Day 1"
+    string getTime() const {
+        return formatFlightTime(departure);
+    }
+
+    int getDeparture() const {
+        return departure;
+    }
+
+    // O(1), the last crew member takes the place of the removed one
+    void removeCrew(int idx) {
+        crew[idx] = crew.back();
+        crew.pop_back();
+    }
+
+    void setDeparture(int newDeparture) {
+        departure = newDeparture;
+        if (table) table->setDeparture(tableRow, departure);
+        //cout << "\nNew time has been set Successfully.\n";
+    }
+
+    void reroute(string newRoute) {
+
+        // Airline::rerouteFlight resolves the new airports, which writes them through to the table
+        route = newRoute;
+        fareVersion++;
+    }
+
+    // Getter for seat map
+    const SeatMap& getSeats() const {
+        return seats;
+    }
+
+    // Claims the first free seat of the cabin without taking the flight's lock
+    // Returns the seat number, or -1 straight away if the cabin is full
+    int claimSeat(SeatType seatType) {
+        int seatNo = seats.reserve(seatType);
+        if (seatNo >= 0) fareVersion++;
+        return seatNo;
+    }
+
+    // Gives back a seat claimed with claimSeat that was never confirmed
+    void unclaimSeat(SeatType seatType, int seatNo) {
+        if (seats.release(seatType, seatNo)) fareVersion++;
+    }
+
+    // Records the passenger on a seat claimed with claimSeat, caller holds getLock()
+    void confirmSeat(Passenger* passenger, SeatType seatType) {
+        passengers.push_back(passenger);
+        updateDemand(seatType);
+    }
+
+    // Claims the first free seat of the cabin for the passenger
+    // Returns the seat number, or -1 if the cabin is full
+    int makeReservation(Passenger* passenger, SeatType seatType) {
+        int seatNo = seats.reserve(seatType);
+        if (seatNo >= 0) {
+            passengers.push_back(passenger);
+            updateDemand(seatType);
+        }
+        return seatNo;
+    }
+
+    // Gives the passenger's seat back to the cabin
+    void cancelReservation(Passenger* passenger, SeatType seatType, int seatNo) {
+        if (!seats.release(seatType, seatNo)) return;
+        updateDemand(seatType);
+        for (size_t i = 0; i < passengers.size(); i++) {
+            if (passengers[i] == passenger) {
+                passengers[i] = passengers.back();
+                passengers.pop_back();
+                break;
+            }
+        }
+    }
+};
+
+
+// Passenger class
+class Passenger {
+private:
+    string name;
+    vector<Reservation*> reservations;
+    bool loyaltyEligibility;
+    string seat;
+    mutex lock; // Held while the reservations of the passenger change
+    PassengerObserver observer; // Notices about the flights of the passenger's reservations
+
+public:
+    Passenger(string name) : name(name), loyaltyEligibility(rand() % 2) {}
+
+    PassengerObserver& getObserver() {
+        return observer;
+    }
+
+    mutex& getLock() {
+        return lock;
+    }
+
+    // Adds a reservation whose seats were already claimed on its flights
+    void addReservation(Reservation* reservation) {
+        reservations.push_back(reservation);
+    }
+
+    // Gives the seats of the reservation back and returns it so its owner can release it
+    Reservation* cancelReservation(int idx);
+
+    vector<Reservation*>& getReservations() { return reservations; }
+
+    // Moves the reservation to another cabin, returns false if a leg has no free seat there
+    bool modifyReservation(int idx, SeatType chosenSeatType);
+
+    void setName(string name) {
+        this->name = name;
+    }
+
+    string getName() const {
+        return name;
+    }
+
+    void setSeat(string newSeat) {
+        seat = newSeat;
+    }
+
+    string getSeat() const {
+        return seat;
+    }
+
+    bool getEligibility() const {
+        return loyaltyEligibility;
+    }
+
+    void setEligibility(bool eligible) {
+        loyaltyEligibility = eligible;
+    }
+};
+
+// Reservation Class
+class Reservation {
+private:
+    vector<Passenger*> passengers;
+    vector<Flight*> flights;
+    vector<int> seatNumbers; // Seat number on each flight, same order as flights
+    string seat;
+    string specialRequest;
+    //size_t is data type of integer, unassigned data type use for size and count
+    int numPassengers;
+    int numFlights;
+
+public:
+    Reservation(vector<Passenger*> passengers = {}, vector<Flight*> flights = {}, string seat = "")
+        : passengers(passengers), flights(flights), seatNumbers(flights.size(), -1), seat(seat) {
+        numPassengers = passengers.size();
+        numFlights = flights.size();
+    }
+
+    Reservation(Flight* flight, string seat, int seatNo = -1) : seat(seat) {
+        flights.push_back(flight);
+        seatNumbers.push_back(seatNo);
+        numPassengers = 0;
+        numFlights = 1;
+    }
+
+    void changeSeat(string newSeat) {
+        // Implement special request to change seat
+        seat = newSeat;
+    }
+
+    // Getters
+    vector<Passenger*>& getPassengers() {
+        return passengers;
+    }
+
+    vector<Flight*>& getFlights() {
+        return flights;
+    }
+
+    string getSeat() {
+        return seat;
+    }
+
+    vector<int>& getSeatNumbers() {
+        return seatNumbers;
+    }
+
+    string getSpecialRequest() {
+        return specialRequest;
+    }
+
+    size_t getNumPassengers() {
+        return numPassengers;
+    }
+
+    size_t getNumFlights() {
+        return numFlights;
+    }
+
+    // Setters
+    void setPassengers(vector<Passenger*> newPassengers) {
+        passengers = newPassengers;
+        numPassengers = passengers.size();
+    }
+
+    void setFlights(vector<Flight*> newFlights) {
+        flights = newFlights;
+        numFlights = flights.size();
+    }
+
+    void setSeat(string newSeat) {
+        seat = newSeat;
+    }
+
+    void setSpecialRequest(string newSpecialRequest) {
+        specialRequest = newSpecialRequest;
+    }
+};
+
+Reservation* Passenger::cancelReservation(int idx) {
+    // Give every seat of the reservation back before dropping it
+    Reservation* reservation = reservations[idx];
+    SeatType seatType = convertStringToSeatType(reservation->getSeat());
+    for (size_t i = 0; i < reservation->getFlights().size(); i++) {
+        reservation->getFlights()[i]->cancelReservation(this, seatType, reservation->getSeatNumbers()[i]);
+    }
+    // The last reservation takes its place rather than shifting the rest down
+    reservations[idx] = reservations.back();
+    reservations.pop_back();
+    return reservation;
+}
+
+bool Passenger::modifyReservation(int idx, SeatType chosenSeatType) {
+    // Move every leg to the new cabin, keeping the old seats if any leg is full
+    Reservation* reservation = reservations[idx];
+    SeatType oldSeatType = convertStringToSeatType(reservation->getSeat());
+    if (chosenSeatType == oldSeatType) return true;
+    vector<Flight*>& legs = reservation->getFlights();
+    vector<int> newSeats;
+    for (size_t i = 0; i < legs.size(); i++) {
+        int seatNo = legs[i]->makeReservation(this, chosenSeatType);
+        if (seatNo < 0) {
+            for (size_t j = 0; j < newSeats.size(); j++) legs[j]->cancelReservation(this, chosenSeatType, newSeats[j]);
+            return false;
+        }
+        newSeats.push_back(seatNo);
+    }
+    for (size_t i = 0; i < legs.size(); i++) {
+        legs[i]->cancelReservation(this, oldSeatType, reservation->getSeatNumbers()[i]);
+        reservation->getSeatNumbers()[i] = newSeats[i];
+    }
+    seat = convertSeatTypeToString(chosenSeatType);
+    reservations[idx]->changeSeat(seat);
+    return true;
+}
+
+// Crew class
+class Crew {
+private:
+    string name;
+    string role;
+    // Assignments are checked before they are added, so neighbouring duties don't
+    // overlap and a check only looks at the two duties either side of the new one
+    DutyMap duties;
+    CrewState curr; // States of crew (Available or training)
+    bool compliance; // Compliance with aviation regulations
+    int id = 0; // Assigned by Airline::createCrew
+    CrewPoolSlot poolSlot;
+    CrewObserver observer; // Notices about the flights the crew is on duty for
+
+public:
+    Crew(string name, string role, CrewState curr, bool compliance)
+        : name(name), role(role), curr(curr), compliance(compliance) {}
+
+    // Getters
+    int getId() const { return id; }
+    string getName() const { return name; }
+    string getRole() const { return role; }
+    // Flights of the crew in order of departure
+    vector<Flight*> getFlights() const {
+        vector<Flight*> flights;
+        for (auto& duty : duties) flights.push_back(duty.second);
+        return flights;
+    }
+    CrewState getState() const { return curr; }
+    bool getCompliance() const { return compliance; }
+
+    // Setters
+    void setId(int id) { this->id = id; }
+    void setName(string name) { this->name = name; }
+    void setRole(string role) {
+        this->role = role;
+        if (poolSlot.pool) poolSlot.pool->reindex(this);
+    }
+    void setFlights(vector<Flight*> flights) {
+        duties.clear();
+        for (Flight* flight : flights) assignFlight(flight);
+    }
+    void setState(CrewState state) {
+        this->curr = state;
+        if (poolSlot.pool) poolSlot.pool->reindex(this);
+    }
+    void setCompliance(bool compliance) {
+        this->compliance = compliance;
+        if (poolSlot.pool) poolSlot.pool->reindex(this);
+    }
+
+    CrewObserver& getObserver() { return observer; }
+
+    // Called by CrewPool when the crew joins, moves within or leaves a pool
+    CrewPoolSlot& getPoolSlot() { return poolSlot; }
+    const CrewPoolSlot& getPoolSlot() const { return poolSlot; }
+
+    // Adds the duty without checking it, see checkDuty
+    void assignFlight(Flight* flight) {
+        duties[{ flight->getDeparture(), flight->getId() }] = flight;
+    }
+
+    // Call before the flight's departure changes, the duty is keyed by it
+    void removeFlight(Flight* flight) {
+        duties.erase({ flight->getDeparture(), flight->getId() });
+    }
+
+    // Checks a duty on the flight against the crew's other duties, O(log n)
+    DutyConflict checkDuty(const Flight* flight, Flight** clash = nullptr) const {
+        return checkDutyAt(duties, flight->getDeparture(), clash);
+    }
+
+    size_t getDutyCount() const {
+        return duties.size();
+    }
+};
+
+uint32_t CrewPool::bucketOf(const Crew* crew) {
+    CrewRole role;
+    int roleKey = convertStringToCrewRole(crew->getRole(), role) ? static_cast<int>(role) : CREW_ROLE_COUNT;
+    return bucketOf(roleKey, crew->getState(), crew->getCompliance());
+}
+
+void CrewPool::file(Crew* crew) {
+    CrewPoolSlot& slot = crew->getPoolSlot();
+    slot.bucket = bucketOf(crew);
+    slot.bucketIndex = static_cast<uint32_t>(buckets[slot.bucket].size());
+    buckets[slot.bucket].push_back(crew);
+}
+
+void CrewPool::unfile(Crew* crew) {
+    CrewPoolSlot& slot = crew->getPoolSlot();
+    vector<Crew*>& bucket = buckets[slot.bucket];
+    bucket[slot.bucketIndex] = bucket.back();
+    bucket[slot.bucketIndex]->getPoolSlot().bucketIndex = slot.bucketIndex;
+    bucket.pop_back();
+}
+
+void CrewPool::add(Crew* crew) {
+    CrewPoolSlot& slot = crew->getPoolSlot();
+    if (slot.pool) return;
+    slot.pool = this;
+    slot.index = static_cast<uint32_t>(members.size());
+    members.push_back(crew);
+    file(crew);
+}
+
+bool CrewPool::remove(Crew* crew) {
+    if (!contains(crew)) return false;
+    CrewPoolSlot& slot = crew->getPoolSlot();
+    unfile(crew);
+    members[slot.index] = members.back();
+    members[slot.index]->getPoolSlot().index = slot.index;
+    members.pop_back();
+    slot = CrewPoolSlot();
+    return true;
+}
+
+bool CrewPool::contains(const Crew* crew) const {
+    return crew->getPoolSlot().pool == this;
+}
+
+void CrewPool::reindex(Crew* crew) {
+    if (!contains(crew) || crew->getPoolSlot().bucket == bucketOf(crew)) return;
+    unfile(crew);
+    file(crew);
+}
+
+// Two duties of one crew that clash
+struct DutyViolation {
+    Crew* crew;
+    Flight* first; // Departs no later than second
+    Flight* second;
+    DutyConflict conflict;
+};
+
+// Bulk check of a roster of (crew, flight) duties, which need not be assigned yet: sorts
+// them by crew and departure, then compares each duty with the one before it. Since every
+// flight lasts BLOCK_MINUTES the duty before always ends last. O(n log n) for n duties.
+void validateRoster(vector<pair<Crew*, Flight*>> roster, vector<DutyViolation>& found) {
+    found.clear();
+    sort(roster.begin(), roster.end(), [](const pair<Crew*, Flight*>& a, const pair<Crew*, Flight*>& b) {
+        if (a.first != b.first) return a.first->getId() < b.first->getId();
+        if (a.second->getDeparture() != b.second->getDeparture()) return a.second->getDeparture() < b.second->getDeparture();
+        return a.second->getId() < b.second->getId();
+    });
+    for (size_t i = 1; i < roster.size(); i++) {
+        if (roster[i].first != roster[i - 1].first) continue;
+        int previousEnd = roster[i - 1].second->getDeparture() + BLOCK_MINUTES;
+        int start = roster[i].second->getDeparture();
+        if (previousEnd > start) found.push_back(DutyViolation{ roster[i].first, roster[i - 1].second, roster[i].second, DutyConflict::Overlap });
+        else if (previousEnd + MIN_REST_MINUTES > start) found.push_back(DutyViolation{ roster[i].first, roster[i - 1].second, roster[i].second, DutyConflict::ShortRest });
+    }
+}
+
+
+bool FileHandler::readFile(const string& path, string& buffer) {
+    // One bulk read of the whole file; a memory map would avoid the copy but is not portable to the Windows build
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) return false;
+    file.seekg(0, ios::end);
+    streamoff size = file.tellg();
+    file.seekg(0, ios::beg);
+    buffer.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    if (!buffer.empty()) file.read(&buffer[0], buffer.size());
+    buffer.resize(static_cast<size_t>(file.gcount()));
+    return true;
+}
+
+// Implementation of FileHandler readData method
+// The file is tokenized in place and the flights and crews are built straight into the airline's storage
+void FileHandler::readData(Airline& airline) {
+    auto start = chrono::steady_clock::now();
+    lastLoad = LoadStats();
+
+    string buffer;
+    if (!readFile(filePath, buffer)) {
+        cerr << "Error: Unable to open file " << filePath << endl;
+        return;
+    }
+    lastLoad.bytes = buffer.size();
+
+    const char* data = buffer.data();
+    const char* end = data + buffer.size();
+    size_t lineCount = count(buffer.begin(), buffer.end(), '\n') + 1;
+    airline.reserveStorage(lineCount, lineCount);
+
+    forEachScheduleRow(data, end,
+        [&](const ScheduleRow& row, FlightStatus currentStatus) {
+            bool crewCompliance = (row.crewCompliance == "1");
+            CrewState crewState = (row.crewState == "Available") ? CrewState::Available : CrewState::Training;
+
+            Flight* flight = airline.createFlight(string(row.route), scheduleFileDeparture(airline.getFlights().size()));
+            flight->setStatus(currentStatus);
+            flight->setPrice(100 + rand() % 50);
+
+            Crew* crew = airline.createCrew(string(row.crewName), string(row.crewRole), crewState, crewCompliance);
+            airline.addFlight(flight);
+            airline.addCrew(crew);
+            lastLoad.rows++;
+        },
+        [&](const ScheduleRow& row) {
+            cerr << "Error: Invalid flight state encountered: " << row.flightState << endl;
+            lastLoad.skipped++;
+        });
+
+    lastLoad.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// One schedule row converted off the main thread, ready to be moved into a Flight and a Crew
+struct ParsedScheduleRow {
+    bool valid;
+    FlightStatus status;
+    string route; // Holds the unknown state text when the row is not valid
+    string crewName;
+    string crewRole;
+    bool crewCompliance;
+    CrewState crewState;
+};
+
+// Implementation of FileHandler readDataParallel method
+void FileHandler::readDataParallel(Airline& airline, unsigned threadCount) {
+    // Below this size the pool costs more than it saves
+    const size_t minParallelBytes = 1 << 20;
+
+    auto start = chrono::steady_clock::now();
+    lastLoad = LoadStats();
+
+    string buffer;
+    if (!readFile(filePath, buffer)) {
+        cerr << "Error: Unable to open file " << filePath << endl;
+        return;
+    }
+    lastLoad.bytes = buffer.size();
+    if (!threadCount) threadCount = max(1u, thread::hardware_concurrency());
+    if (threadCount == 1 || buffer.size() < minParallelBytes) {
+        readData(airline);
+        return;
+    }
+
+    // Split at line boundaries, a few chunks per thread so uneven lines still balance
+    const char* data = buffer.data();
+    const char* end = data + buffer.size();
+    size_t chunkCount = threadCount * 4;
+    size_t chunkSize = buffer.size() / chunkCount + 1;
+    vector<pair<const char*, const char*>> chunks;
+    while (data < end) {
+        const char* chunkEnd = data + min(chunkSize, static_cast<size_t>(end - data));
+        if (chunkEnd < end) {
+            const char* newline = static_cast<const char*>(memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = newline ? newline + 1 : end;
+        }
+        chunks.push_back(make_pair(data, chunkEnd));
+        data = chunkEnd;
+    }
+
+    vector<vector<ParsedScheduleRow>> parsed(chunks.size());
+    ThreadPool pool(threadCount);
+    pool.run(chunks.size(), [&](size_t c) {
+        vector<ParsedScheduleRow>& rows = parsed[c];
+        rows.reserve(count(chunks[c].first, chunks[c].second, '\n') + 1);
+        forEachScheduleRow(chunks[c].first, chunks[c].second,
+            [&](const ScheduleRow& row, FlightStatus status) {
+                ParsedScheduleRow out;
+                out.valid = true;
+                out.status = status;
+                out.route = string(row.route);
+                out.crewName = string(row.crewName);
+                out.crewRole = string(row.crewRole);
+                out.crewCompliance = (row.crewCompliance == "1");
+                out.crewState = (row.crewState == "Available") ? CrewState::Available : CrewState::Training;
+                rows.push_back(std::move(out));
+            },
+            [&](const ScheduleRow& row) {
+                ParsedScheduleRow out;
+                out.valid = false;
+                out.route = string(row.flightState);
+                rows.push_back(std::move(out));
+            });
+    });
+
+    // Merge in file order so ids, prices and error messages match readData
+    size_t total = 0;
+    for (size_t c = 0; c < parsed.size(); c++) total += parsed[c].size();
+    airline.reserveStorage(total, total);
+    for (size_t c = 0; c < parsed.size(); c++) {
+        for (size_t i = 0; i < parsed[c].size(); i++) {
+            ParsedScheduleRow& row = parsed[c][i];
+            if (!row.valid) {
+                cerr << "Error: Invalid flight state encountered: " << row.route << endl;
+                lastLoad.skipped++;
+                continue;
+            }
+            Flight* flight = airline.createFlight(std::move(row.route), scheduleFileDeparture(airline.getFlights().size()));
+            flight->setStatus(row.status);
+            flight->setPrice(100 + rand() % 50);
+
+            Crew* crew = airline.createCrew(std::move(row.crewName), std::move(row.crewRole), row.crewState, row.crewCompliance);
+            airline.addFlight(flight);
+            airline.addCrew(crew);
+            lastLoad.rows++;
+        }
+        vector<ParsedScheduleRow>().swap(parsed[c]);
+    }
+
+    lastLoad.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Parses one factor row, returns false for comments, blank or malformed lines
+bool parseFactorRow(string_view line, string& route, RouteFactors& factors) {
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    if (line.empty() || line[0] == '#') return false;
+    size_t comma = line.find(',');
+    if (comma == string_view::npos) return false;
+    route = string(line.substr(0, comma));
+    double* fields[] = { &factors.basePrice, &factors.demandFactor, &factors.seasonalFactor, &factors.eventFactor };
+    stringstream values(string(line.substr(comma + 1)));
+    for (double* field : fields) {
+        string value;
+        if (!getline(values, value, ',')) return false;
+        char* end = nullptr;
+        *field = strtod(value.c_str(), &end);
+        if (end == value.c_str()) return false;
+    }
+    return true;
+}
+
+// Implementation of FileHandler loadFactors method
+bool FileHandler::loadFactors(PricingTable& table, RouteFactors defaults) {
+    string buffer;
+    if (!readFile(factorPath, buffer)) return false;
+    RouteFactorTable* factors = new RouteFactorTable();
+    factors->defaults = defaults;
+    string_view data(buffer);
+    while (!data.empty()) {
+        size_t newline = data.find('\n');
+        string_view line = data.substr(0, newline);
+        data = (newline == string_view::npos) ? string_view() : data.substr(newline + 1);
+        string route;
+        RouteFactors row;
+        if (!parseFactorRow(line, route, row)) continue;
+        if (route == "*") factors->defaults = row;
+        else factors->routes[route] = row;
+    }
+    table.publish(factors);
+    return true;
+}
+
+// Implementation of FileHandler updateData method
+bool FileHandler::updateData(string route, double basePrice, double demandFactor, double seasonalFactor, double eventFactor) {
+    // Keep every other line as it is and replace (or append) the row of this route
+    string buffer;
+    readFile(factorPath, buffer);
+    stringstream row;
+    row << route << "," << basePrice << "," << demandFactor << "," << seasonalFactor << "," << eventFactor;
+    string updated;
+    bool replaced = false;
+    string_view data(buffer);
+    while (!data.empty()) {
+        size_t newline = data.find('\n');
+        string_view line = data.substr(0, newline);
+        data = (newline == string_view::npos) ? string_view() : data.substr(newline + 1);
+        string lineRoute;
+        RouteFactors factors;
+        if (parseFactorRow(line, lineRoute, factors) && lineRoute == route) {
+            if (replaced) continue;
+            updated += row.str();
+            replaced = true;
+        }
+        else {
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            updated += line;
+        }
+        updated += '\n';
+    }
+    if (!replaced) updated += row.str() + '\n';
+
+    // Swap the new file in so the watcher never reads half of it
+    string tempPath = factorPath + ".tmp";
+    ofstream out(tempPath, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cerr << "Error: Unable to open file " << tempPath << endl;
+        return false;
+    }
+    out << updated;
+    out.close();
+    if (!out) return false;
+    return replaceFile(tempPath, factorPath);
+}
+
+template <typename... Args>
+Flight* Airline::createFlight(Args&&... args) {
+    return flightStore.create(std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+Crew* Airline::createCrew(Args&&... args) {
+    Crew* crew = crewStore.create(std::forward<Args>(args)...);
+    crew->setId(nextCrewId++);
+    crewsById[crew->getId()] = crew;
+    return crew;
+}
+
+void Airline::priceFareGrid(const PricingEngine& engine, vector<double>& grid) const {
+    // Gather the base fares into one flat array, then price them in a single pass
+    vector<double> baseFares(flights.size() * CABIN_COUNT);
+    for (size_t i = 0; i < flights.size(); i++) {
+        double base = flights[i]->getPrice();
+        for (int cabin = 0; cabin < CABIN_COUNT; cabin++) baseFares[i * CABIN_COUNT + cabin] = base + CABIN_SURCHARGE[cabin];
+    }
+    engine.calculatePrices(baseFares, grid);
+}
+
+void Airline::priceFareGrid(PricingTable& pricing, vector<double>& grid) const {
+    // One table for the whole grid, and one batch per route since its flights share factors
+    shared_lock<shared_mutex> catalog(catalogLock);
+    PricingTable::ReadGuard table(pricing);
+    grid.assign(flights.size() * CABIN_COUNT, 0);
+    unordered_map<int, size_t> position;
+    for (size_t i = 0; i < flights.size(); i++) position[flights[i]->getId()] = i;
+    vector<double> baseFares;
+    vector<double> fares;
+    for (auto& route : flightsByRoute) {
+        const RouteFactors& factors = table->lookup(route.second[0]->getRoute());
+        baseFares.clear();
+        for (Flight* flight : route.second) {
+            double base = factors.basePrice ? factors.basePrice : flight->getPrice();
+            for (int cabin = 0; cabin < CABIN_COUNT; cabin++) baseFares.push_back(base + CABIN_SURCHARGE[cabin]);
+        }
+        factors.engine().calculatePrices(baseFares, fares);
+        for (size_t f = 0; f < route.second.size(); f++) {
+            size_t row = position[route.second[f]->getId()];
+            lock_guard<mutex> flightGuard(route.second[f]->getLock());
+            for (int cabin = 0; cabin < CABIN_COUNT; cabin++) {
+                grid[row * CABIN_COUNT + cabin] = fares[f * CABIN_COUNT + cabin] * route.second[f]->getDemandMultiplier(static_cast<SeatType>(cabin));
+            }
+        }
+    }
+}
+
+void Airline::restoreCrewId(Crew* crew, int id) {
+    crewsById.erase(crew->getId());
+    crew->setId(id);
+    crewsById[id] = crew;
+    if (id >= nextCrewId) nextCrewId = id + 1;
+}
+
+template <typename... Args>
+Reservation* Airline::createReservation(Args&&... args) {
+    lock_guard<mutex> guard(reservationLock);
+    return reservationStore.create(std::forward<Args>(args)...);
+}
+
+void Airline::releaseReservation(Reservation* reservation) {
+    lock_guard<mutex> guard(reservationLock);
+    reservationStore.release(reservation);
+}
+
+void Airline::printMemoryUsage(ostream& out) {
+    auto print = [&out](const char* label, const PoolUsage& usage) {
+        out << label << usage.live << " live, " << usage.free << " reusable, " << usage.bytes / 1024 << " KB\n";
+    };
+    {
+        shared_lock<shared_mutex> guard(catalogLock);
+        print("Flights         : ", flightStore.usage());
+        print("Crews           : ", crewStore.usage());
+    }
+    {
+        lock_guard<mutex> guard(passengerLock);
+        print("Passengers      : ", passengerStore.usage());
+    }
+    lock_guard<mutex> guard(reservationLock);
+    print("Reservations    : ", reservationStore.usage());
+}
+
+Passenger* Airline::createPassenger(string name) {
+    lock_guard<mutex> guard(passengerLock);
+    return passengerStore.create(name);
+}
+
+void Airline::addPassenger(Passenger* passenger) {
+    uint64_t sequence;
+    {
+        lock_guard<mutex> guard(passengerLock);
+        passengers.push_back(passenger);
+        passengersByName[passenger->getName()] = passenger;
+        sequence = record(JournalOp::RegisterPassenger, JournalWriter().putString(passenger->getName()).putU8(passenger->getEligibility()));
+    }
+    commit(sequence);
+}
+
+Passenger* Airline::registerPassenger(const string& name) {
+    uint64_t sequence;
+    Passenger* passenger;
+    {
+        lock_guard<mutex> guard(passengerLock);
+        auto it = passengersByName.find(name);
+        if (it != passengersByName.end()) return it->second;
+        passenger = passengerStore.create(name);
+        passengers.push_back(passenger);
+        passengersByName[name] = passenger;
+        sequence = record(JournalOp::RegisterPassenger, JournalWriter().putString(name).putU8(passenger->getEligibility()));
+    }
+    commit(sequence);
+    return passenger;
+}
+
+vector<unique_lock<mutex>> Airline::lockFlights(vector<Flight*> legs) {
+    sort(legs.begin(), legs.end(), [](Flight* a, Flight* b) { return a->getId() < b->getId(); });
+    legs.erase(unique(legs.begin(), legs.end()), legs.end());
+    vector<unique_lock<mutex>> locks;
+    for (Flight* leg : legs) locks.emplace_back(leg->getLock());
+    return locks;
+}
+
+uint32_t FlightTable::add(Flight* flight) {
+    uint32_t row = static_cast<uint32_t>(flights.size());
+    flights.push_back(flight);
+    flightIds.push_back(flight->getId());
+    statuses.push_back(static_cast<uint8_t>(flight->getStatus()));
+    departures.push_back(flight->getDeparture());
+    origins.push_back(flight->getOrigin());
+    destinations.push_back(flight->getDestination());
+    prices.push_back(flight->getPrice());
+    for (int cabin = 0; cabin < CABIN_COUNT; cabin++) {
+        freeSeats[cabin].push_back(static_cast<uint16_t>(flight->getSeats().freeSeats(static_cast<SeatType>(cabin))));
+    }
+    flight->setTableRow(this, row);
+    return row;
+}
+
+void FlightTable::remove(uint32_t row) {
+    uint32_t last = static_cast<uint32_t>(flights.size() - 1);
+    flights[row]->setTableRow(nullptr, 0);
+    if (row != last) {
+        flights[row] = flights[last];
+        flightIds[row] = flightIds[last];
+        statuses[row] = statuses[last];
+        departures[row] = departures[last];
+        origins[row] = origins[last];
+        destinations[row] = destinations[last];
+        prices[row] = prices[last];
+        for (int cabin = 0; cabin < CABIN_COUNT; cabin++) freeSeats[cabin][row] = freeSeats[cabin][last];
+        flights[row]->setTableRow(this, row);
+    }
+    flights.pop_back();
+    flightIds.pop_back();
+    statuses.pop_back();
+    departures.pop_back();
+    origins.pop_back();
+    destinations.pop_back();
+    prices.pop_back();
+    for (int cabin = 0; cabin < CABIN_COUNT; cabin++) freeSeats[cabin].pop_back();
+}
+
+void Airline::findOpenFlights(FlightStatus status, SeatType seatType, vector<Flight*>& found) const {
+    shared_lock<shared_mutex> guard(catalogLock);
+    vector<uint32_t> rows;
+    flightTable.selectOpen(status, seatType, rows);
+    flightTable.sortById(rows);
+    found.clear();
+    for (uint32_t row : rows) found.push_back(flightTable.getFlight(row));
+}
+
+void Airline::findFlightsDeparting(int from, int to, vector<Flight*>& found) const {
+    shared_lock<shared_mutex> guard(catalogLock);
+    found.clear();
+    auto last = flightsByDeparture.lower_bound({ to, INT_MIN });
+    for (auto it = flightsByDeparture.lower_bound({ from, INT_MIN }); it != last; ++it) found.push_back(it->second);
+}
+
+int Airline::findFreeSlot(int after) const {
+    shared_lock<shared_mutex> guard(catalogLock);
+    int slot = (max(after, 0) + SLOT_MINUTES - 1) / SLOT_MINUTES * SLOT_MINUTES;
+    auto it = flightsByDeparture.lower_bound({ slot, INT_MIN });
+    while (it != flightsByDeparture.end() && it->first.first < slot + SLOT_MINUTES) {
+        slot += SLOT_MINUTES;
+        it = flightsByDeparture.lower_bound({ slot, INT_MIN });
+    }
+    return slot;
+}
+
+void Airline::resolveAirports(Flight* flight) {
+    string route = flight->getRoute();
+    string_view origin, destination;
+    if (splitRoute(route, origin, destination)) flight->setAirports(airports.intern(origin), airports.intern(destination));
+    else flight->setAirports(airports.intern(route), NO_AIRPORT);
+}
+
+void Airline::indexFlight(Flight* flight) {
+    resolveAirports(flight);
+    flightsById[flight->getId()] = flight;
+    flightsByRoute[routeKey(flight->getOrigin(), flight->getDestination())].push_back(flight);
+    flightsByDeparture[{ flight->getDeparture(), flight->getId() }] = flight;
+    routeGraph.addFlight(flight->getOrigin(), flight->getDestination());
+    flightsByStatus[static_cast<int>(flight->getStatus())][flight->getId()] = flight;
+}
+
+void Airline::unindexFlight(Flight* flight) {
+    flightsById.erase(flight->getId());
+    uint64_t key = routeKey(flight->getOrigin(), flight->getDestination());
+    vector<Flight*>& sameRoute = flightsByRoute[key];
+    for (size_t i = 0; i < sameRoute.size(); i++) {
+        if (sameRoute[i] == flight) {
+            sameRoute[i] = sameRoute.back();
+            sameRoute.pop_back();
+            break;
+        }
+    }
+    if (sameRoute.empty()) flightsByRoute.erase(key);
+    flightsByDeparture.erase({ flight->getDeparture(), flight->getId() });
+    routeGraph.removeFlight(flight->getOrigin(), flight->getDestination());
+    flightsByStatus[static_cast<int>(flight->getStatus())].erase(flight->getId());
+}
+
+void Airline::insertFlight(Flight* flight) {
+    if (!flight->getId()) flight->setId(nextFlightId++);
+    else if (flight->getId() >= nextFlightId) nextFlightId = flight->getId() + 1;
+    flights.push_back(flight);
+    indexFlight(flight);
+    flightTable.add(flight);
+}
+
+void Airline::addFlight(Flight* flight) {
+    unique_lock<shared_mutex> guard(catalogLock);
+    insertFlight(flight);
+}
+
+Flight* Airline::scheduleFlight(string route, int departure) {
+    string_view origin, destination;
+    if (!splitRoute(route, origin, destination)) return nullptr;
+    uint64_t sequence;
+    Flight* flight;
+    {
+        unique_lock<shared_mutex> guard(catalogLock);
+        flight = createFlight(route, departure);
+        insertFlight(flight);
+        sequence = record(JournalOp::ScheduleFlight, JournalWriter().putI32(flight->getId()).putString(route).putI32(departure).putI32(flight->getPrice()));
+    }
+    commit(sequence);
+    return flight;
+}
+
+bool Airline::removeFlight(Flight* flight) {
+    uint64_t sequence;
+    {
+        unique_lock<shared_mutex> guard(catalogLock);
+        if (!flight->getPassengers().empty()) return false;
+        sequence = record(JournalOp::RemoveFlight, JournalWriter().putI32(flight->getId()));
+        dropFlight(flight);
+        // Nothing refers to a flight without passengers once it left the catalog, so its slot is reused
+        flightStore.release(flight);
+    }
+    commit(sequence);
+    return true;
+}
+
+void Airline::dropFlight(Flight* flight) {
+    unindexFlight(flight);
+    flightTable.remove(flight->getTableRow());
+    for (size_t i = 0; i < flights.size(); i++) {
+        if (flights[i] == flight) {
+            flights.erase(flights.begin() + i);
+            break;
+        }
+    }
+    // The crew of a removed flight is freed of its duty, the flight itself stays in the storage
+    for (size_t i = 0; i < flight->getCrew().size(); i++) flight->getCrew()[i]->removeFlight(flight);
+    flight->getCrew().clear();
+}
+
+bool Airline::setFlightStatus(Flight* flight, FlightStatus status) {
+    uint64_t sequence;
+    FlightNotice notice;
+    {
+        unique_lock<shared_mutex> guard(catalogLock);
+        FlightStatus oldStatus = flight->getStatus();
+        if (!flight->transitionTo(status)) return false;
+        if (oldStatus != status) {
+            flightsByStatus[static_cast<int>(oldStatus)].erase(flight->getId());
+            flightsByStatus[static_cast<int>(status)][flight->getId()] = flight;
+        }
+        sequence = record(JournalOp::SetStatus, JournalWriter().putI32(flight->getId()).putU8(static_cast<uint8_t>(status)));
+        notice.flightId = flight->getId();
+        notice.route = flight->getRoute();
+        notice.from = oldStatus;
+        notice.to = status;
+    }
+    commit(sequence);
+    if (notice.from != notice.to) notify(std::move(notice));
+    return true;
+}
+
+bool Airline::rerouteFlight(Flight* flight, string newRoute) {
+    string_view origin, destination;
+    if (!splitRoute(newRoute, origin, destination)) return false;
+    uint64_t sequence;
+    {
+        unique_lock<shared_mutex> guard(catalogLock);
+        // Nothing changes for the passengers, so there is nothing to journal or tell them
+        if (newRoute == flight->getRoute()) return true;
+        unindexFlight(flight);
+        flight->reroute(newRoute);
+        indexFlight(flight);
+        sequence = record(JournalOp::Reroute, JournalWriter().putI32(flight->getId()).putString(newRoute));
+    }
+    commit(sequence);
+    FlightNotice notice;
+    notice.kind = NoticeKind::Reroute;
+    notice.flightId = flight->getId();
+    notice.route = newRoute;
+    notify(std::move(notice));
+    return true;
+}
+
+void Airline::setFlightTime(Flight* flight, int departure) {
+    uint64_t sequence;
+    FlightNotice notice;
+    notice.kind = NoticeKind::Retime;
+    {
+        unique_lock<shared_mutex> guard(catalogLock);
+        notice.flightId = flight->getId();
+        notice.route = flight->getRoute();
+        notice.oldDeparture = flight->getDeparture();
+        notice.newDeparture = departure;
+        flightsByDeparture.erase({ flight->getDeparture(), flight->getId() });
+        // The crew keep their duty, conflicts it now causes are reported by handleScheduleConflicts
+        for (Crew* crew : flight->getCrew()) crew->removeFlight(flight);
+        flight->setDeparture(departure);
+        for (Crew* crew : flight->getCrew()) crew->assignFlight(flight);
+        flightsByDeparture[{ departure, flight->getId() }] = flight;
+        sequence = record(JournalOp::SetDeparture, JournalWriter().putI32(flight->getId()).putI32(departure));
+    }
+    commit(sequence);
+    if (notice.oldDeparture != notice.newDeparture) notify(std::move(notice));
+}
+
+void Airline::setFlightPrice(Flight* flight, int newPrice) {
+    uint64_t sequence;
+    {
+        unique_lock<shared_mutex> guard(catalogLock);
+        flight->setPrice(newPrice);
+        sequence = record(JournalOp::SetPrice, JournalWriter().putI32(flight->getId()).putI32(newPrice));
+    }
+    commit(sequence);
+}
+
+double Airline::quoteFare(Flight* flight, SeatType seatType, PricingTable& pricing) const {
+    shared_lock<shared_mutex> guard(catalogLock);
+    return flight->quoteFare(seatType, pricing);
+}
+
+Reservation* Airline::bookFlight(Passenger* passenger, Flight* flight, SeatType seatType) {
+    uint64_t sequence;
+    Reservation* reservation;
+    {
+        shared_lock<shared_mutex> catalog(catalogLock);
+        // The seat is claimed lock-free, a session that loses the race for the last seat
+        // gets nullptr here without ever waiting on the winner
+        int seatNo = flight->claimSeat(seatType);
+        if (seatNo < 0) return nullptr;
+        // Only the bookkeeping of this flight is locked, bookings on other flights go ahead in parallel
+        lock_guard<mutex> passengerGuard(passenger->getLock());
+        lock_guard<mutex> flightGuard(flight->getLock());
+        flight->confirmSeat(passenger, seatType);
+        reservation = createReservation(flight, convertSeatTypeToString(seatType), seatNo);
+        passenger->addReservation(reservation);
+        sequence = record(JournalOp::Book, JournalWriter().putString(passenger->getName()).putI32(flight->getId())
+            .putU8(static_cast<uint8_t>(seatType)).putI32(seatNo));
+    }
+    commit(sequence);
+    return reservation;
+}
+
+void Airline::cancelReservation(Passenger* passenger, int idx) {
+    uint64_t sequence;
+    {
+        shared_lock<shared_mutex> catalog(catalogLock);
+        lock_guard<mutex> passengerGuard(passenger->getLock());
+        vector<unique_lock<mutex>> legLocks = lockFlights(passenger->getReservations()[idx]->getFlights());
+        releaseReservation(passenger->cancelReservation(idx));
+        sequence = record(JournalOp::Cancel, JournalWriter().putString(passenger->getName()).putI32(idx));
+    }
+    commit(sequence);
+}
+
+bool Airline::rebookReservation(Passenger* passenger, Reservation* reservation, const vector<Flight*>& legs, bool durable) {
+    uint64_t sequence;
+    {
+        shared_lock<shared_mutex> catalog(catalogLock);
+        lock_guard<mutex> passengerGuard(passenger->getLock());
+        vector<Reservation*>& reservations = passenger->getReservations();
+        int idx = static_cast<int>(find(reservations.begin(), reservations.end(), reservation) - reservations.begin());
+        if (static_cast<size_t>(idx) == reservations.size() || legs.empty()) return false;
+        SeatType seatType = convertStringToSeatType(reservation->getSeat());
+        vector<Flight*> touched = reservation->getFlights();
+        touched.insert(touched.end(), legs.begin(), legs.end());
+        vector<unique_lock<mutex>> legLocks = lockFlights(touched);
+
+        // Claim every new seat before giving any old one up, so a failure leaves the booking as it was
+        vector<int> seatNumbers;
+        for (Flight* leg : legs) {
+            int seatNo = leg->getStatus() == FlightStatus::Scheduled ? leg->claimSeat(seatType) : -1;
+            if (seatNo < 0) {
+                for (size_t i = 0; i < seatNumbers.size(); i++) legs[i]->unclaimSeat(seatType, seatNumbers[i]);
+                return false;
+            }
+            seatNumbers.push_back(seatNo);
+        }
+        for (size_t i = 0; i < reservation->getFlights().size(); i++) {
+            reservation->getFlights()[i]->cancelReservation(passenger, seatType, reservation->getSeatNumbers()[i]);
+        }
+        for (Flight* leg : legs) leg->confirmSeat(passenger, seatType);
+        reservation->setFlights(legs);
+        reservation->getSeatNumbers() = seatNumbers;
+
+        JournalWriter payload;
+        payload.putString(passenger->getName()).putI32(idx).putI32(static_cast<int32_t>(legs.size()));
+        for (size_t i = 0; i < legs.size(); i++) payload.putI32(legs[i]->getId()).putI32(seatNumbers[i]);
+        sequence = record(JournalOp::Rebook, payload);
+    }
+    if (durable) commit(sequence);
+    return true;
+}
+
+bool Airline::modifyReservation(Passenger* passenger, int idx, SeatType seatType) {
+    uint64_t sequence;
+    {
+        shared_lock<shared_mutex> catalog(catalogLock);
+        lock_guard<mutex> passengerGuard(passenger->getLock());
+        vector<unique_lock<mutex>> legLocks = lockFlights(passenger->getReservations()[idx]->getFlights());
+        if (!passenger->modifyReservation(idx, seatType)) return false;
+        // Seats are claimed without the flight lock, so the record names the exact seats: replaying
+        // a first free seat claim could take one that a booking journaled later was given
+        const vector<int>& seatNumbers = passenger->getReservations()[idx]->getSeatNumbers();
+        JournalWriter payload;
+        payload.putString(passenger->getName()).putI32(idx).putU8(static_cast<uint8_t>(seatType)).putI32(static_cast<int32_t>(seatNumbers.size()));
+        for (int seatNo : seatNumbers) payload.putI32(seatNo);
+        sequence = record(JournalOp::ModifySeats, payload);
+    }
+    commit(sequence);
+    return true;
+}
+
+void Airline::setSpecialRequest(Passenger* passenger, int idx, string request) {
+    uint64_t sequence;
+    {
+        lock_guard<mutex> passengerGuard(passenger->getLock());
+        passenger->getReservations()[idx]->setSpecialRequest(request);
+        sequence = record(JournalOp::SpecialRequest, JournalWriter().putString(passenger->getName()).putI32(idx).putString(request));
+    }
+    commit(sequence);
+}
+
+void Airline::removeCrewFromFlight(Flight* flight, int idx) {
+    uint64_t sequence;
+    {
+        unique_lock<shared_mutex> guard(catalogLock);
+        Crew* crew = flight->getCrew()[idx];
+        crew->removeFlight(flight);
+        flight->removeCrew(idx);
+        sequence = record(JournalOp::RemoveCrew, JournalWriter().putI32(flight->getId()).putI32(crew->getId()));
+    }
+    commit(sequence);
+}
+
+bool Airline::applyJournalRecord(uint64_t sequence, JournalOp op, JournalReader& reader) {
+    // Replays run with the journal detached so nothing is logged twice
+    Journal* attached = journal;
+    journal = nullptr;
+    bool applied = false;
+    switch (op) {
+    case JournalOp::RegisterPassenger: {
+        string name = reader.getString();
+        bool eligible = reader.getU8() != 0;
+        if (!reader.ok() || findPassenger(name)) break;
+        Passenger* passenger = createPassenger(name);
+        passenger->setEligibility(eligible);
+        addPassenger(passenger);
+        applied = true;
+        break;
+    }
+    case JournalOp::Book: {
+        Passenger* passenger = findPassenger(reader.getString());
+        Flight* flight = getFlightById(reader.getI32());
+        uint8_t cabin = reader.getU8();
+        int seatNo = reader.getI32();
+        // The checksum doesn't catch a record written by another build, so check enums before the cast
+        if (!reader.ok() || !passenger || !flight || cabin >= CABIN_COUNT) break;
+        SeatType seatType = static_cast<SeatType>(cabin);
+        // Claim the exact seat that was given out, not just the first free one
+        if (!flight->restoreReservation(passenger, seatType, seatNo)) break;
+        passenger->addReservation(createReservation(flight, convertSeatTypeToString(seatType), seatNo));
+        applied = true;
+        break;
+    }
+    case JournalOp::Cancel: {
+        Passenger* passenger = findPassenger(reader.getString());
+        int idx = reader.getI32();
+        if (!reader.ok() || !passenger || idx < 0 || static_cast<size_t>(idx) >= passenger->getReservations().size()) break;
+        cancelReservation(passenger, idx);
+        applied = true;
+        break;
+    }
+    case JournalOp::Modify: {
+        Passenger* passenger = findPassenger(reader.getString());
+        int idx = reader.getI32();
+        uint8_t cabin = reader.getU8();
+        if (!reader.ok() || !passenger || idx < 0 || static_cast<size_t>(idx) >= passenger->getReservations().size() || cabin >= CABIN_COUNT) break;
+        applied = modifyReservation(passenger, idx, static_cast<SeatType>(cabin));
+        break;
+    }
+    case JournalOp::ModifySeats: {
+        Passenger* passenger = findPassenger(reader.getString());
+        int idx = reader.getI32();
+        uint8_t cabin = reader.getU8();
+        int legCount = reader.getI32();
+        vector<int> seatNumbers;
+        for (int i = 0; i < legCount && reader.ok(); i++) seatNumbers.push_back(reader.getI32());
+        if (!reader.ok() || !passenger || idx < 0 || idx >= static_cast<int>(passenger->getReservations().size()) || cabin >= CABIN_COUNT) break;
+        Reservation* reservation = passenger->getReservations()[idx];
+        vector<Flight*>& legs = reservation->getFlights();
+        SeatType seatType = static_cast<SeatType>(cabin);
+        SeatType oldSeatType = convertStringToSeatType(reservation->getSeat());
+        if (seatNumbers.size() != legs.size()) break;
+        if (seatType == oldSeatType) {
+            applied = seatNumbers == reservation->getSeatNumbers();
+            break;
+        }
+        // Take the exact new seats first so a seat that can't be had leaves the booking as it was
+        size_t claimed = 0;
+        while (claimed < legs.size() && legs[claimed]->restoreReservation(passenger, seatType, seatNumbers[claimed])) claimed++;
+        if (claimed < legs.size()) {
+            for (size_t i = 0; i < claimed; i++) legs[i]->cancelReservation(passenger, seatType, seatNumbers[i]);
+            break;
+        }
+        for (size_t i = 0; i < legs.size(); i++) legs[i]->cancelReservation(passenger, oldSeatType, reservation->getSeatNumbers()[i]);
+        reservation->getSeatNumbers() = seatNumbers;
+        passenger->setSeat(convertSeatTypeToString(seatType));
+        reservation->changeSeat(convertSeatTypeToString(seatType));
+        applied = true;
+        break;
+    }
+    case JournalOp::SpecialRequest: {
+        Passenger* passenger = findPassenger(reader.getString());
+        int idx = reader.getI32();
+        string request = reader.getString();
+        if (!reader.ok() || !passenger || idx < 0 || static_cast<size_t>(idx) >= passenger->getReservations().size()) break;
+        setSpecialRequest(passenger, idx, request);
+        applied = true;
+        break;
+    }
+    case JournalOp::AssignCrew:
+    case JournalOp::RemoveCrew: {
+        Flight* flight = getFlightById(reader.getI32());
+        Crew* crew = getCrewById(reader.getI32());
+        if (!reader.ok() || !flight || !crew) break;
+        if (op == JournalOp::AssignCrew) {
+            applied = assignCrewToFlight(flight, crew) == DutyConflict::None;
+            break;
+        }
+        for (size_t i = 0; i < flight->getCrew().size(); i++) {
+            if (flight->getCrew()[i] == crew) {
+                removeCrewFromFlight(flight, i);
+                applied = true;
+                break;
+            }
+        }
+        break;
+    }
+    case JournalOp::Reroute: {
+        Flight* flight = getFlightById(reader.getI32());
+        string route = reader.getString();
+        if (!reader.ok() || !flight) break;
+        applied = rerouteFlight(flight, route);
+        break;
+    }
+    case JournalOp::SetTime:
+    case JournalOp::SetDeparture: {
+        Flight* flight = getFlightById(reader.getI32());
+        int departure = op == JournalOp::SetTime ? parseFlightTime(reader.getString()) : reader.getI32();
+        if (!reader.ok() || !flight || departure < 0) break;
+        setFlightTime(flight, departure);
+        applied = true;
+        break;
+    }
+    case JournalOp::SetStatus: {
+        Flight* flight = getFlightById(reader.getI32());
+        uint8_t status = reader.getU8();
+        if (!reader.ok() || !flight || status >= FLIGHT_STATUS_COUNT) break;
+        applied = setFlightStatus(flight, static_cast<FlightStatus>(status));
+        break;
+    }
+    case JournalOp::SetPrice: {
+        Flight* flight = getFlightById(reader.getI32());
+        int newPrice = reader.getI32();
+        if (!reader.ok() || !flight) break;
+        setFlightPrice(flight, newPrice);
+        applied = true;
+        break;
+    }
+    case JournalOp::AddFlight:
+    case JournalOp::ScheduleFlight: {
+        int id = reader.getI32();
+        string route = reader.getString();
+        int departure = op == JournalOp::AddFlight ? parseFlightTime(reader.getString()) : reader.getI32();
+        int flightPrice = reader.getI32();
+        string_view origin, destination;
+        if (!reader.ok() || getFlightById(id) || departure < 0 || !splitRoute(route, origin, destination)) break;
+        Flight* flight = createFlight(route, departure, flightPrice);
+        flight->setId(id);
+        addFlight(flight);
+        applied = true;
+        break;
+    }
+    case JournalOp::RemoveFlight: {
+        Flight* flight = getFlightById(reader.getI32());
+        if (!reader.ok() || !flight) break;
+        applied = removeFlight(flight);
+        break;
+    }
+    case JournalOp::Rebook: {
+        Passenger* passenger = findPassenger(reader.getString());
+        int idx = reader.getI32();
+        int legCount = reader.getI32();
+        vector<Flight*> legs;
+        vector<int> seatNumbers;
+        for (int i = 0; i < legCount && reader.ok(); i++) {
+            legs.push_back(getFlightById(reader.getI32()));
+            seatNumbers.push_back(reader.getI32());
+        }
+        if (!reader.ok() || !passenger || idx < 0 || static_cast<size_t>(idx) >= passenger->getReservations().size() || legs.empty()
+            || find(legs.begin(), legs.end(), nullptr) != legs.end()) break;
+        // Take the exact seats that were given out before giving the old ones up, like
+        // rebookReservation, so a seat that can't be had leaves the booking as it was
+        Reservation* reservation = passenger->getReservations()[idx];
+        SeatType seatType = convertStringToSeatType(reservation->getSeat());
+        size_t claimed = 0;
+        while (claimed < legs.size() && legs[claimed]->restoreReservation(passenger, seatType, seatNumbers[claimed])) claimed++;
+        if (claimed < legs.size()) {
+            for (size_t i = 0; i < claimed; i++) legs[i]->cancelReservation(passenger, seatType, seatNumbers[i]);
+            break;
+        }
+        for (size_t i = 0; i < reservation->getFlights().size(); i++) {
+            reservation->getFlights()[i]->cancelReservation(passenger, seatType, reservation->getSeatNumbers()[i]);
+        }
+        reservation->setFlights(legs);
+        reservation->getSeatNumbers() = seatNumbers;
+        applied = true;
+        break;
+    }
+    }
+    journal = attached;
+    // A refused record is not reflected, so a snapshot taken now doesn't claim to cover it
+    if (applied) journalSequence = sequence;
+    return applied;
+}
+
+// Builds the sections of a snapshot in memory before writing them in one go
+class SnapshotWriter {
+private:
+    string strings;
+
+public:
+    vector<SnapshotFlight> flights;
+    vector<SnapshotCrew> crews;
+    vector<uint32_t> crewLinks;
+    vector<SnapshotPassenger> passengers;
+    vector<SnapshotReservation> reservations;
+    vector<SnapshotLeg> legs;
+    uint64_t journalSequence = 0;
+
+    SnapshotString addString(const string& text) {
+        SnapshotString ref;
+        ref.offset = static_cast<uint32_t>(strings.size());
+        ref.length = static_cast<uint32_t>(text.size());
+        strings += text;
+        return ref;
+    }
+
+    bool write(const string& path) {
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.flightCount = static_cast<uint32_t>(flights.size());
+        header.crewCount = static_cast<uint32_t>(crews.size());
+        header.crewLinkCount = static_cast<uint32_t>(crewLinks.size());
+        header.passengerCount = static_cast<uint32_t>(passengers.size());
+        header.reservationCount = static_cast<uint32_t>(reservations.size());
+        header.legCount = static_cast<uint32_t>(legs.size());
+        header.journalSequence = journalSequence;
+
+        // Every section starts on an 8 byte boundary so the loader can use the records in place
+        uint64_t offset = sizeof(header);
+        auto place = [&offset](size_t bytes) {
+            uint64_t start = offset;
+            offset = (offset + bytes + 7) & ~7ULL;
+            return start;
+        };
+        header.flightOffset = place(flights.size() * sizeof(SnapshotFlight));
+        header.crewOffset = place(crews.size() * sizeof(SnapshotCrew));
+        header.crewLinkOffset = place(crewLinks.size() * sizeof(uint32_t));
+        header.passengerOffset = place(passengers.size() * sizeof(SnapshotPassenger));
+        header.reservationOffset = place(reservations.size() * sizeof(SnapshotReservation));
+        header.legOffset = place(legs.size() * sizeof(SnapshotLeg));
+        header.stringOffset = place(strings.size());
+        header.stringBytes = strings.size();
+
+        string image(offset, '\0');
+        memcpy(&image[0], &header, sizeof(header));
+        if (!flights.empty()) memcpy(&image[header.flightOffset], flights.data(), flights.size() * sizeof(SnapshotFlight));
+        if (!crews.empty()) memcpy(&image[header.crewOffset], crews.data(), crews.size() * sizeof(SnapshotCrew));
+        if (!crewLinks.empty()) memcpy(&image[header.crewLinkOffset], crewLinks.data(), crewLinks.size() * sizeof(uint32_t));
+        if (!passengers.empty()) memcpy(&image[header.passengerOffset], passengers.data(), passengers.size() * sizeof(SnapshotPassenger));
+        if (!reservations.empty()) memcpy(&image[header.reservationOffset], reservations.data(), reservations.size() * sizeof(SnapshotReservation));
+        if (!legs.empty()) memcpy(&image[header.legOffset], legs.data(), legs.size() * sizeof(SnapshotLeg));
+        if (!strings.empty()) memcpy(&image[header.stringOffset], strings.data(), strings.size());
+
+        // Write to a temporary file first so a crash never leaves a half written snapshot behind
+        string tempPath = path + ".tmp";
+        ofstream file(tempPath, ios::binary | ios::trunc);
+        if (!file.is_open()) return false;
+        file.write(image.data(), image.size());
+        file.close();
+        if (!file) return false;
+        return replaceFile(tempPath, path);
+    }
+};
+
+// Implementation of FileHandler saveSnapshot method
+bool FileHandler::saveSnapshot(const Airline& airline, const string& path) {
+    SnapshotWriter writer;
+    unordered_map<const Flight*, uint32_t> flightIndex;
+    unordered_map<const Crew*, uint32_t> crewIndex;
+
+    auto addCrew = [&](Crew* crew, bool inPool) {
+        auto found = crewIndex.find(crew);
+        if (found != crewIndex.end()) return found->second;
+        SnapshotCrew record;
+        memset(&record, 0, sizeof(record));
+        record.id = crew->getId();
+        record.name = writer.addString(crew->getName());
+        record.role = writer.addString(crew->getRole());
+        record.state = static_cast<uint8_t>(crew->getState());
+        record.compliance = crew->getCompliance();
+        record.inPool = inPool;
+        uint32_t index = static_cast<uint32_t>(writer.crews.size());
+        writer.crews.push_back(record);
+        crewIndex[crew] = index;
+        return index;
+    };
+    for (size_t i = 0; i < airline.getCrews().size(); i++) addCrew(airline.getCrews()[i], true);
+
+    for (size_t i = 0; i < airline.getFlights().size(); i++) {
+        Flight* flight = airline.getFlights()[i];
+        SnapshotFlight record;
+        memset(&record, 0, sizeof(record));
+        record.id = flight->getId();
+        record.price = flight->getPrice();
+        record.status = static_cast<uint8_t>(flight->getStatus());
+        record.route = writer.addString(flight->getRoute());
+        record.departure = flight->getDeparture();
+        record.firstCrew = static_cast<uint32_t>(writer.crewLinks.size());
+        record.crewCount = static_cast<uint32_t>(flight->getCrew().size());
+        for (size_t c = 0; c < flight->getCrew().size(); c++) writer.crewLinks.push_back(addCrew(flight->getCrew()[c], false));
+        for (int from = 0; from < FLIGHT_STATUS_COUNT; from++)
+            for (int to = 0; to < FLIGHT_STATUS_COUNT; to++)
+                record.transitionCounts[from][to] = flight->getTransitionCount(static_cast<FlightStatus>(from), static_cast<FlightStatus>(to));
+        record.rejectedTransitions = flight->getRejectedTransitions();
+        flightIndex[flight] = static_cast<uint32_t>(writer.flights.size());
+        writer.flights.push_back(record);
+    }
+
+    for (size_t i = 0; i < airline.getPassengers().size(); i++) {
+        Passenger* passenger = airline.getPassengers()[i];
+        SnapshotPassenger record;
+        memset(&record, 0, sizeof(record));
+        record.name = writer.addString(passenger->getName());
+        record.seat = writer.addString(passenger->getSeat());
+        record.loyaltyEligibility = passenger->getEligibility();
+        record.firstReservation = static_cast<uint32_t>(writer.reservations.size());
+        record.reservationCount = static_cast<uint32_t>(passenger->getReservations().size());
+        for (size_t r = 0; r < passenger->getReservations().size(); r++) {
+            Reservation* reservation = passenger->getReservations()[r];
+            SnapshotReservation saved;
+            saved.seat = writer.addString(reservation->getSeat());
+            saved.specialRequest = writer.addString(reservation->getSpecialRequest());
+            saved.firstLeg = static_cast<uint32_t>(writer.legs.size());
+            saved.legCount = static_cast<uint32_t>(reservation->getFlights().size());
+            for (size_t l = 0; l < reservation->getFlights().size(); l++) {
+                SnapshotLeg leg;
+                leg.flight = flightIndex[reservation->getFlights()[l]];
+                leg.seatNo = reservation->getSeatNumbers()[l];
+                writer.legs.push_back(leg);
+            }
+            writer.reservations.push_back(saved);
+        }
+        writer.passengers.push_back(record);
+    }
+
+    writer.journalSequence = airline.getJournalSequence();
+    return writer.write(path);
+}
+
+// Implementation of FileHandler loadSnapshot method
+bool FileHandler::loadSnapshot(Airline& airline, const string& path) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) return false;
+    file.seekg(0, ios::end);
+    streamoff size = file.tellg();
+    file.seekg(0, ios::beg);
+    if (size < static_cast<streamoff>(sizeof(SnapshotHeader))) return false;
+
+    // 8 byte aligned image so the record sections can be used in place
+    vector<uint64_t> image((static_cast<size_t>(size) + 7) / 8);
+    char* base = reinterpret_cast<char*>(image.data());
+    if (!file.read(base, size)) return false;
+
+    const SnapshotHeader* header = reinterpret_cast<const SnapshotHeader*>(base);
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 || header->version != SNAPSHOT_VERSION) {
+        cerr << "Error: " << path << " is not a compatible snapshot" << endl;
+        return false;
+    }
+    // Every section has to lie inside the file on an 8 byte boundary
+    uint64_t fileBytes = static_cast<uint64_t>(size);
+    auto fits = [fileBytes](uint64_t offset, uint64_t count, uint64_t recordBytes) {
+        return offset % 8 == 0 && offset <= fileBytes && count <= (fileBytes - offset) / recordBytes;
+    };
+    if (!fits(header->flightOffset, header->flightCount, sizeof(SnapshotFlight)) ||
+        !fits(header->crewOffset, header->crewCount, sizeof(SnapshotCrew)) ||
+        !fits(header->crewLinkOffset, header->crewLinkCount, sizeof(uint32_t)) ||
+        !fits(header->passengerOffset, header->passengerCount, sizeof(SnapshotPassenger)) ||
+        !fits(header->reservationOffset, header->reservationCount, sizeof(SnapshotReservation)) ||
+        !fits(header->legOffset, header->legCount, sizeof(SnapshotLeg)) ||
+        !fits(header->stringOffset, header->stringBytes, 1)) {
+        cerr << "Error: " << path << " is truncated or corrupt" << endl;
+        return false;
+    }
+    const SnapshotFlight* flights = reinterpret_cast<const SnapshotFlight*>(base + header->flightOffset);
+    const SnapshotCrew* crews = reinterpret_cast<const SnapshotCrew*>(base + header->crewOffset);
+    const uint32_t* crewLinks = reinterpret_cast<const uint32_t*>(base + header->crewLinkOffset);
+    const SnapshotPassenger* passengers = reinterpret_cast<const SnapshotPassenger*>(base + header->passengerOffset);
+    const SnapshotReservation* reservations = reinterpret_cast<const SnapshotReservation*>(base + header->reservationOffset);
+    const SnapshotLeg* legs = reinterpret_cast<const SnapshotLeg*>(base + header->legOffset);
+    const char* strings = base + header->stringOffset;
+    auto text = [strings](const SnapshotString& ref) { return string(strings + ref.offset, ref.length); };
+
+    // Check every string, index, enum and seat before anything is created, so a corrupt
+    // file is rejected with the airline left as it was
+    auto validString = [header](const SnapshotString& ref) {
+        return ref.offset <= header->stringBytes && ref.length <= header->stringBytes - ref.offset;
+    };
+    auto validRange = [](uint32_t first, uint32_t count, uint32_t total) {
+        return first <= total && count <= total - first;
+    };
+    bool valid = true;
+    for (uint32_t i = 0; valid && i < header->crewCount; i++) {
+        valid = validString(crews[i].name) && validString(crews[i].role) && crews[i].state <= static_cast<uint8_t>(CrewState::Training);
+    }
+    for (uint32_t i = 0; valid && i < header->crewLinkCount; i++) valid = crewLinks[i] < header->crewCount;
+    for (uint32_t i = 0; valid && i < header->flightCount; i++) {
+        valid = validString(flights[i].route) && flights[i].status < FLIGHT_STATUS_COUNT &&
+            validRange(flights[i].firstCrew, flights[i].crewCount, header->crewLinkCount);
+    }
+    for (uint32_t i = 0; valid && i < header->passengerCount; i++) {
+        valid = validString(passengers[i].name) && validString(passengers[i].seat) &&
+            validRange(passengers[i].firstReservation, passengers[i].reservationCount, header->reservationCount);
+    }
+    // Seats as (flight, cabin, seat) keys: each one in its cabin and held by a single leg
+    SeatMap layout;
+    vector<uint64_t> seatKeys;
+    seatKeys.reserve(header->legCount);
+    for (uint32_t i = 0; valid && i < header->reservationCount; i++) {
+        const SnapshotReservation& saved = reservations[i];
+        valid = validString(saved.seat) && validString(saved.specialRequest) && validRange(saved.firstLeg, saved.legCount, header->legCount);
+        if (!valid) break;
+        SeatType seatType = convertStringToSeatType(text(saved.seat));
+        for (uint32_t l = 0; valid && l < saved.legCount; l++) {
+            const SnapshotLeg& leg = legs[saved.firstLeg + l];
+            valid = leg.flight < header->flightCount && leg.seatNo >= 0 && leg.seatNo < layout.capacity(seatType);
+            seatKeys.push_back((static_cast<uint64_t>(leg.flight) << 32) | (static_cast<uint64_t>(seatType) << 16) | static_cast<uint64_t>(leg.seatNo));
+        }
+    }
+    if (valid) {
+        sort(seatKeys.begin(), seatKeys.end());
+        valid = adjacent_find(seatKeys.begin(), seatKeys.end()) == seatKeys.end();
+    }
+    if (!valid) {
+        cerr << "Error: " << path << " is corrupt" << endl;
+        return false;
+    }
+
+    airline.reserveStorage(header->flightCount, header->crewCount);
+
+    vector<Crew*> crewObjects(header->crewCount);
+    for (uint32_t i = 0; i < header->crewCount; i++) {
+        crewObjects[i] = airline.createCrew(text(crews[i].name), text(crews[i].role), static_cast<CrewState>(crews[i].state), crews[i].compliance != 0);
+        airline.restoreCrewId(crewObjects[i], crews[i].id);
+        if (crews[i].inPool) airline.addCrew(crewObjects[i]);
+    }
+
+    vector<Flight*> flightObjects(header->flightCount);
+    for (uint32_t i = 0; i < header->flightCount; i++) {
+        const SnapshotFlight& record = flights[i];
+        Flight* flight = airline.createFlight(text(record.route), record.departure, record.price);
+        flight->setId(record.id);
+        flight->setStatus(static_cast<FlightStatus>(record.status));
+        flight->restoreTransitionCounts(record.transitionCounts, record.rejectedTransitions);
+        for (uint32_t c = 0; c < record.crewCount; c++) {
+            Crew* crew = crewObjects[crewLinks[record.firstCrew + c]];
+            flight->getCrew().push_back(crew);
+            crew->assignFlight(flight);
+        }
+        airline.addFlight(flight);
+        flightObjects[i] = flight;
+    }
+
+    for (uint32_t i = 0; i < header->passengerCount; i++) {
+        const SnapshotPassenger& record = passengers[i];
+        Passenger* passenger = airline.createPassenger(text(record.name));
+        passenger->setSeat(text(record.seat));
+        passenger->setEligibility(record.loyaltyEligibility != 0);
+        for (uint32_t r = 0; r < record.reservationCount; r++) {
+            const SnapshotReservation& saved = reservations[record.firstReservation + r];
+            string seat = text(saved.seat);
+            SeatType seatType = convertStringToSeatType(seat);
+            vector<Flight*> legFlights;
+            vector<int> legSeats;
+            for (uint32_t l = 0; l < saved.legCount; l++) {
+                const SnapshotLeg& leg = legs[saved.firstLeg + l];
+                // The checks above rule this out; a leg without its seat would break the inventory
+                if (!flightObjects[leg.flight]->restoreReservation(passenger, seatType, leg.seatNo)) {
+                    cerr << "Error: " << path << " is corrupt, seat " << leg.seatNo + 1 << " of flight " << flightObjects[leg.flight]->getId() << " can't be restored" << endl;
+                    return false;
+                }
+                legFlights.push_back(flightObjects[leg.flight]);
+                legSeats.push_back(leg.seatNo);
+            }
+            Reservation* reservation = airline.createReservation(vector<Passenger*>(), legFlights, seat);
+            reservation->getSeatNumbers() = legSeats;
+            reservation->setSpecialRequest(text(saved.specialRequest));
+            passenger->addReservation(reservation);
+        }
+        airline.addPassenger(passenger);
+    }
+    airline.setJournalSequence(header->journalSequence);
+    return true;
+}
+
+void Airline::collectSubscribers(int flightId, vector<Observer*>& found) const {
+    found.clear();
+    shared_lock<shared_mutex> guard(catalogLock);
+    auto it = flightsById.find(flightId);
+    if (it == flightsById.end()) return;
+    Flight* flight = it->second;
+    for (Crew* crew : flight->getCrew()) found.push_back(&crew->getObserver());
+    {
+        lock_guard<mutex> flightGuard(flight->getLock());
+        for (Passenger* passenger : flight->getPassengers()) found.push_back(&passenger->getObserver());
+    }
+    // A passenger with two reservations on the flight is told once
+    sort(found.begin(), found.end());
+    found.erase(unique(found.begin(), found.end()), found.end());
+}
+
+DutyConflict Airline::assignCrewToFlight(Flight* flight, Crew* crew) {
+    uint64_t sequence;
+    {
+        unique_lock<shared_mutex> guard(catalogLock);
+        DutyConflict conflict = crew->checkDuty(flight);
+        if (conflict != DutyConflict::None) return conflict;
+        // Assign crew to the flight, the crew stays in the pool for flights at other times
+        flight->getCrew().push_back(crew);
+        crew->assignFlight(flight);
+        sequence = record(JournalOp::AssignCrew, JournalWriter().putI32(flight->getId()).putI32(crew->getId()));
+    }
+    commit(sequence);
+    return DutyConflict::None;
+}
+
+size_t Airline::applyRoster(const vector<pair<Crew*, Flight*>>& roster) {
+    uint64_t sequence = 0;
+    size_t applied = 0;
+    {
+        unique_lock<shared_mutex> guard(catalogLock);
+        for (const pair<Crew*, Flight*>& duty : roster) {
+            if (duty.first->checkDuty(duty.second) != DutyConflict::None) continue;
+            duty.second->getCrew().push_back(duty.first);
+            duty.first->assignFlight(duty.second);
+            sequence = record(JournalOp::AssignCrew, JournalWriter().putI32(duty.second->getId()).putI32(duty.first->getId()));
+            applied++;
+        }
+    }
+    // One sync covers the whole batch
+    commit(sequence);
+    return applied;
+}
+
+void Airline::handleScheduleConflicts(Flight* flight, vector<DutyViolation>& found) const {
+    shared_lock<shared_mutex> guard(catalogLock);
+    vector<pair<Crew*, Flight*>> roster;
+    for (Crew* crew : flight->getCrew()) {
+        for (Flight* duty : crew->getFlights()) roster.push_back({ crew, duty });
+    }
+    ::validateRoster(std::move(roster), found);
+    size_t kept = 0;
+    for (size_t i = 0; i < found.size(); i++) {
+        if (found[i].first == flight || found[i].second == flight) found[kept++] = found[i];
+    }
+    found.resize(kept);
+}
+
+void Airline::validateRoster(vector<DutyViolation>& found) const {
+    shared_lock<shared_mutex> guard(catalogLock);
+    vector<pair<Crew*, Flight*>> roster;
+    for (Flight* flight : flights) {
+        for (Crew* crew : flight->getCrew()) roster.push_back({ crew, flight });
+    }
+    ::validateRoster(std::move(roster), found);
+}
+
+// How itineraries are ranked
+enum class ItineraryOrder {
+    Price,
+    Arrival
+};
+
+// One journey from origin to destination, one flight per leg
+struct Itinerary {
+    vector<Flight*> legs;
+    int departure = 0; // Minutes after midnight of Day 1
+    int arrival = 0;
+    double fare = 0; // Sum of the quoted fares of the legs
+};
+
+// ItineraryPlanner class
+// Finds connections of up to K stops between two airports with a round based search in
+// the style of McRAPTOR: round r extends every journey found in round r - 1 by one more
+// flight, so after K + 1 rounds every journey of at most K stops has been seen. Each
+// airport keeps a bag of journeys where none is both cheaper and earlier than another,
+// which makes the answer exact for both rankings.
+// build() copies the bookable flights of one cabin into arrays grouped by graph edge and
+// sorted by departure, so a query never touches the catalog. Rebuild it after the
+// catalog or the fares change. A planner keeps scratch space between queries, so each
+// thread needs its own.
+class ItineraryPlanner {
+private:
+    static const uint32_t NONE = UINT32_MAX;
+
+    struct Leg {
+        int32_t departure;
+        int32_t arrival;
+        double fare;
+        uint32_t nextCheaper; // Next later leg on the same edge with a lower fare, or NONE
+        Flight* flight;
+    };
+
+    struct EdgeLegs {
+        uint32_t destination;
+        uint32_t firstLeg;
+        uint32_t legCount;
+        double minFare;
+    };
+
+    struct Label {
+        int32_t arrival;
+        double fare;
+        uint32_t airport;
+        uint32_t parent; // Label this journey extends, NONE for the start
+        uint32_t leg; // Leg taken from the parent's airport
+        bool dominated;
+    };
+
+    // Edges of airport a are edges[firstEdge[a]] up to edges[firstEdge[a + 1]]
+    vector<uint32_t> firstEdge;
+    vector<EdgeLegs> edges;
+    vector<Leg> legs;
+    // Same edges seen from their destination: origins and edge ids of edges into airport a
+    // are at firstInEdge[a] up to firstInEdge[a + 1]
+    vector<uint32_t> firstInEdge;
+    vector<uint32_t> inEdgeOrigins;
+    vector<uint32_t> inEdges;
+
+    // Query scratch
+    vector<Label> labels;
+    vector<vector<uint32_t>> bags; // Label ids per airport
+    vector<uint32_t> touched; // Airports whose bags need clearing
+    vector<uint32_t> marked; // Labels created in the last round
+    vector<int> legsToTarget; // Fewest legs from each airport to the query's destination
+    vector<double> fareToTarget; // Lower bound on the fare from each airport to the destination
+    double cheapestLeg = 0; // Lowest fare of any leg
+
+    // Lower bounds for the rest of a journey from every airport: a breadth first walk over
+    // the edges into the destination gives the legs still needed, and every leg costs at
+    // least cheapestLeg, the last one at least the cheapest leg into the destination
+    void measureDistanceToTarget(uint32_t target) {
+        size_t airportCount = firstInEdge.size() - 1;
+        legsToTarget.assign(airportCount, INT_MAX);
+        legsToTarget[target] = 0;
+        vector<uint32_t> queue(1, target);
+        for (size_t head = 0; head < queue.size(); head++) {
+            uint32_t at = queue[head];
+            for (uint32_t i = firstInEdge[at]; i < firstInEdge[at + 1]; i++) {
+                uint32_t from = inEdgeOrigins[i];
+                if (legsToTarget[from] != INT_MAX) continue;
+                legsToTarget[from] = legsToTarget[at] + 1;
+                queue.push_back(from);
+            }
+        }
+
+        double lastLeg = DBL_MAX;
+        for (uint32_t i = firstInEdge[target]; i < firstInEdge[target + 1]; i++) lastLeg = min(lastLeg, edges[inEdges[i]].minFare);
+        fareToTarget.resize(airportCount);
+        for (size_t a = 0; a < airportCount; a++) {
+            fareToTarget[a] = legsToTarget[a] == INT_MAX ? DBL_MAX : legsToTarget[a] ? lastLeg + (legsToTarget[a] - 1) * cheapestLeg : 0;
+        }
+        // One leg from a neighbour is either its direct flight or a longer, dearer journey
+        for (uint32_t i = firstInEdge[target]; i < firstInEdge[target + 1]; i++) {
+            fareToTarget[inEdgeOrigins[i]] = min(edges[inEdges[i]].minFare, lastLeg + cheapestLeg);
+        }
+    }
+
+    // Adds the journey to the airport's bag unless a journey there is as early and as cheap
+    bool addLabel(int32_t arrival, double fare, uint32_t airport, uint32_t parent, uint32_t leg) {
+        vector<uint32_t>& bag = bags[airport];
+        for (uint32_t id : bag) {
+            if (labels[id].arrival <= arrival && labels[id].fare <= fare) return false;
+        }
+        size_t kept = 0;
+        for (uint32_t id : bag) {
+            if (arrival <= labels[id].arrival && fare <= labels[id].fare) labels[id].dominated = true;
+            else bag[kept++] = id;
+        }
+        bag.resize(kept);
+        if (bag.empty()) touched.push_back(airport);
+        uint32_t id = static_cast<uint32_t>(labels.size());
+        labels.push_back(Label{ arrival, fare, airport, parent, leg, false });
+        bag.push_back(id);
+        marked.push_back(id);
+        return true;
+    }
+
+    // True if a journey already at the target is as early and as cheap
+    bool prunedByTarget(uint32_t target, int32_t arrival, double fare) const {
+        for (uint32_t id : bags[target]) {
+            if (labels[id].arrival <= arrival && labels[id].fare <= fare) return true;
+        }
+        return false;
+    }
+
+    // Same, for a journey that has reached airport and still has to get to the target
+    bool prunedFrom(uint32_t target, uint32_t airport, int32_t arrival, double fare) const {
+        return prunedByTarget(target, arrival + legsToTarget[airport] * (MIN_CONNECTION_MINUTES + BLOCK_MINUTES), fare + fareToTarget[airport]);
+    }
+
+public:
+    // Indexes the Scheduled flights that have a free seat in the cabin
+    void build(const Airline& airline, SeatType seatType, PricingTable& pricing) {
+        auto guard = airline.readCatalog();
+        const AirportRegistry& airports = airline.getAirports();
+        const RouteGraph& graph = airline.getRouteGraph();
+        firstEdge.assign(1, 0);
+        edges.clear();
+        legs.clear();
+        for (uint32_t origin = 0; origin < airports.size(); origin++) {
+            for (const RouteGraph::Edge& edge : graph.getRoutesFrom(origin)) {
+                uint32_t first = static_cast<uint32_t>(legs.size());
+                for (Flight* flight : airline.getFlightsByRoute(origin, edge.destination)) {
+                    int departure = flight->getDeparture();
+                    if (flight->getStatus() != FlightStatus::Scheduled || !flight->getSeats().freeSeats(seatType)) continue;
+                    legs.push_back(Leg{ departure, departure + BLOCK_MINUTES, flight->quoteFare(seatType, pricing), NONE, flight });
+                }
+                if (legs.size() == first) continue;
+                sort(legs.begin() + first, legs.end(), [](const Leg& a, const Leg& b) { return a.departure < b.departure; });
+                double minFare = legs[first].fare;
+                // Walk back from the last departure with a stack of ever cheaper legs
+                vector<uint32_t> cheaper;
+                for (uint32_t i = static_cast<uint32_t>(legs.size()); i-- > first;) {
+                    while (!cheaper.empty() && legs[cheaper.back()].fare >= legs[i].fare) cheaper.pop_back();
+                    legs[i].nextCheaper = cheaper.empty() ? NONE : cheaper.back();
+                    cheaper.push_back(i);
+                    minFare = min(minFare, legs[i].fare);
+                }
+                edges.push_back(EdgeLegs{ edge.destination, first, static_cast<uint32_t>(legs.size()) - first, minFare });
+            }
+            firstEdge.push_back(static_cast<uint32_t>(edges.size()));
+        }
+
+        cheapestLeg = 0;
+        if (!edges.empty()) cheapestLeg = min_element(edges.begin(), edges.end(), [](const EdgeLegs& a, const EdgeLegs& b) { return a.minFare < b.minFare; })->minFare;
+
+        // Counting sort of the edges by destination
+        firstInEdge.assign(airports.size() + 1, 0);
+        for (const EdgeLegs& edge : edges) firstInEdge[edge.destination + 1]++;
+        for (size_t a = 0; a < airports.size(); a++) firstInEdge[a + 1] += firstInEdge[a];
+        inEdgeOrigins.resize(edges.size());
+        inEdges.resize(edges.size());
+        vector<uint32_t> fill(firstInEdge.begin(), firstInEdge.end() - 1);
+        for (uint32_t origin = 0; origin < airports.size(); origin++) {
+            for (uint32_t e = firstEdge[origin]; e < firstEdge[origin + 1]; e++) {
+                uint32_t slot = fill[edges[e].destination]++;
+                inEdgeOrigins[slot] = origin;
+                inEdges[slot] = e;
+            }
+        }
+        bags.assign(airports.size(), vector<uint32_t>());
+    }
+
+    size_t getLegCount() const {
+        return legs.size();
+    }
+
+    // Fills found with the journeys from origin to destination leaving no earlier than
+    // earliest with at most maxStops stops, best first, at most limit of them
+    void search(uint32_t origin, uint32_t destination, int earliest, int maxStops, ItineraryOrder order, size_t limit, vector<Itinerary>& found) {
+        found.clear();
+        if (origin >= bags.size() || destination >= bags.size() || origin == destination) return;
+        for (uint32_t airport : touched) bags[airport].clear();
+        touched.clear();
+        labels.clear();
+        marked.clear();
+        measureDistanceToTarget(destination);
+        if (legsToTarget[origin] > maxStops + 1) return;
+        addLabel(earliest, 0, origin, NONE, NONE);
+
+        vector<uint32_t> round;
+        for (int r = 0; r <= maxStops && !marked.empty(); r++) {
+            round.swap(marked);
+            marked.clear();
+            for (uint32_t from : round) {
+                if (labels[from].dominated || labels[from].airport == destination) continue;
+                // Copied, addLabel may grow labels
+                const Label label = labels[from];
+                // The target may have improved since this journey was found
+                if (label.parent != NONE && prunedFrom(destination, label.airport, label.arrival, label.fare)) continue;
+                int ready = label.arrival + (label.parent == NONE ? 0 : MIN_CONNECTION_MINUTES);
+                for (uint32_t e = firstEdge[label.airport]; e < firstEdge[label.airport + 1]; e++) {
+                    const EdgeLegs& edge = edges[e];
+                    if (edge.destination == origin) continue;
+                    // Skip airports the destination can't be reached from in the legs left
+                    if (legsToTarget[edge.destination] > maxStops - r) continue;
+                    if (prunedFrom(destination, edge.destination, ready + BLOCK_MINUTES, label.fare + edge.minFare)) continue;
+                    auto begin = legs.begin() + edge.firstLeg;
+                    auto end = begin + edge.legCount;
+                    auto catchable = lower_bound(begin, end, ready, [](const Leg& leg, int time) { return leg.departure < time; });
+                    // The first leg is the earliest, each later one worth taking is cheaper
+                    for (uint32_t i = catchable == end ? NONE : static_cast<uint32_t>(catchable - legs.begin()); i != NONE; i = legs[i].nextCheaper) {
+                        double fare = label.fare + legs[i].fare;
+                        // A journey short of the destination can at best fly the remaining legs back to back at their lowest fares
+                        if (prunedFrom(destination, edge.destination, legs[i].arrival, fare)) continue;
+                        addLabel(legs[i].arrival, fare, edge.destination, from, i);
+                    }
+                }
+            }
+        }
+
+        for (uint32_t id : bags[destination]) {
+            Itinerary itinerary;
+            itinerary.arrival = labels[id].arrival;
+            itinerary.fare = labels[id].fare;
+            for (uint32_t at = id; labels[at].parent != NONE; at = labels[at].parent) {
+                itinerary.legs.push_back(legs[labels[at].leg].flight);
+                itinerary.departure = legs[labels[at].leg].departure;
+            }
+            reverse(itinerary.legs.begin(), itinerary.legs.end());
+            found.push_back(std::move(itinerary));
+        }
+        sort(found.begin(), found.end(), [order](const Itinerary& a, const Itinerary& b) {
+            if (order == ItineraryOrder::Price && a.fare != b.fare) return a.fare < b.fare;
+            if (a.arrival != b.arrival) return a.arrival < b.arrival;
+            return a.fare < b.fare;
+        });
+        if (found.size() > limit) found.resize(limit);
+    }
+};
+
+// Results of a rostering run
+struct RosterStats {
+    size_t places = 0; // Crew places missing on Scheduled flights
+    size_t filled = 0; // Places given a crew
+    size_t crewsFreed = 0; // Crew the local search took every new duty from
+    size_t crewsUsed = 0; // Eligible crew with at least one duty
+    size_t eligible = 0; // Compliant, Available crew with a known role
+    size_t days = 0;
+    double seconds = 0;
+};
+
+// RosterSolver class
+// Fills the missing crew places of every Scheduled flight (CREW_MIX of each role) with
+// compliant, Available crew, keeping every crew clear of overlaps and short rest, and
+// using as few crew as it can:
+//  1. The days are planned in parallel. Each day's places are split greedily, in order of
+//     departure, into as few chains as possible, a chain being duties one crew can fly
+//     back to back with MIN_REST_MINUTES in between. Taking intervals in order of start
+//     and reusing any chain that is free makes this optimal for the day.
+//  2. The days are then walked in order, giving every chain to the lowest numbered crew
+//     that has rested since its last chain and whose own duties don't clash. Preferring
+//     the same crew every day keeps the number of crew used down.
+//  3. Local search: the crew with the fewest new duties try to hand all of them to other
+//     working crew, each success frees a crew.
+// plan() only reads the catalog, Airline::applyRoster puts the result in place.
+class RosterSolver {
+private:
+    // Crew the local search tries to free, the lightest ones
+    static const size_t LOCAL_SEARCH_CREW = 256;
+
+    struct Place {
+        Flight* flight;
+        int start;
+        int role;
+    };
+
+    vector<Crew*> candidates[CREW_ROLE_COUNT]; // Crew already working first, then by id
+    vector<Place> places; // By departure
+    vector<size_t> dayStarts; // Index of the first place of each day, then places.size()
+    vector<vector<vector<size_t>>> chains[CREW_ROLE_COUNT]; // Per day, places of each chain
+    vector<DutyMap> planned[CREW_ROLE_COUNT]; // New duties per candidate
+
+    bool fits(int role, int crew, const Place& place) const {
+        return checkDutyAt(planned[role][crew], place.start) == DutyConflict::None
+            && candidates[role][crew]->checkDuty(place.flight) == DutyConflict::None;
+    }
+
+    bool working(int role, int crew) const {
+        return !planned[role][crew].empty() || candidates[role][crew]->getDutyCount();
+    }
+
+    // Phase 1 for one day
+    void chainDay(size_t day) {
+        for (int role = 0; role < CREW_ROLE_COUNT; role++) {
+            vector<vector<size_t>>& dayChains = chains[role][day];
+            priority_queue<pair<int, size_t>, vector<pair<int, size_t>>, greater<pair<int, size_t>>> freeAt; // (free at, chain)
+            for (size_t p = dayStarts[day]; p < dayStarts[day + 1]; p++) {
+                if (places[p].role != role) continue;
+                size_t chain;
+                if (!freeAt.empty() && freeAt.top().first <= places[p].start) {
+                    chain = freeAt.top().second;
+                    freeAt.pop();
+                }
+                else {
+                    chain = dayChains.size();
+                    dayChains.emplace_back();
+                }
+                dayChains[chain].push_back(p);
+                freeAt.push({ places[p].start + BLOCK_MINUTES + MIN_REST_MINUTES, chain });
+            }
+        }
+    }
+
+    // Phase 2
+    void assignChains() {
+        for (int role = 0; role < CREW_ROLE_COUNT; role++) {
+            planned[role].assign(candidates[role].size(), DutyMap());
+            vector<int> order(candidates[role].size());
+            for (size_t i = 0; i < order.size(); i++) order[i] = static_cast<int>(i);
+            priority_queue<int, vector<int>, greater<int>> freeCrew(greater<int>(), std::move(order));
+            priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> busyCrew; // (free at, crew)
+            vector<int> skipped;
+            for (size_t day = 0; day + 1 < dayStarts.size(); day++) {
+                vector<vector<size_t>>& dayChains = chains[role][day];
+                sort(dayChains.begin(), dayChains.end(), [this](const vector<size_t>& a, const vector<size_t>& b) { return places[a[0]].start < places[b[0]].start; });
+                for (const vector<size_t>& chain : dayChains) {
+                    while (!busyCrew.empty() && busyCrew.top().first <= places[chain[0]].start) {
+                        freeCrew.push(busyCrew.top().second);
+                        busyCrew.pop();
+                    }
+                    // Crew whose own duties clash with the chain wait for the next one
+                    skipped.clear();
+                    while (!freeCrew.empty()) {
+                        Crew* crew = candidates[role][freeCrew.top()];
+                        bool clear = true;
+                        for (size_t p : chain) {
+                            if (crew->checkDuty(places[p].flight) != DutyConflict::None) {
+                                clear = false;
+                                break;
+                            }
+                        }
+                        if (clear) break;
+                        skipped.push_back(freeCrew.top());
+                        freeCrew.pop();
+                    }
+                    if (!freeCrew.empty()) {
+                        int crew = freeCrew.top();
+                        freeCrew.pop();
+                        for (size_t p : chain) planned[role][crew][{ places[p].start, places[p].flight->getId() }] = places[p].flight;
+                        busyCrew.push({ places[chain.back()].start + BLOCK_MINUTES + MIN_REST_MINUTES, crew });
+                    }
+                    for (int crew : skipped) freeCrew.push(crew);
+                }
+            }
+        }
+    }
+
+    // Phase 3
+    void shedCrew(RosterStats& stats) {
+        for (int role = 0; role < CREW_ROLE_COUNT; role++) {
+            vector<int> workingCrew;
+            for (int crew = 0; crew < static_cast<int>(candidates[role].size()); crew++) {
+                if (working(role, crew)) workingCrew.push_back(crew);
+            }
+            // Only crew without duties of their own can be freed, lightest first
+            vector<int> order;
+            for (int crew : workingCrew) {
+                if (!candidates[role][crew]->getDutyCount()) order.push_back(crew);
+            }
+            sort(order.begin(), order.end(), [&](int a, int b) { return planned[role][a].size() < planned[role][b].size(); });
+            if (order.size() > LOCAL_SEARCH_CREW) order.resize(LOCAL_SEARCH_CREW);
+            vector<bool> freed(candidates[role].size(), false);
+            for (int crew : order) {
+                DutyMap duties = planned[role][crew];
+                vector<pair<int, DutyMap::value_type>> moved;
+                bool emptied = true;
+                for (const DutyMap::value_type& duty : duties) {
+                    Place place{ duty.second, duty.first.first, role };
+                    int taker = -1;
+                    for (int other : workingCrew) {
+                        if (other != crew && !freed[other] && fits(role, other, place)) {
+                            taker = other;
+                            break;
+                        }
+                    }
+                    if (taker < 0) {
+                        emptied = false;
+                        break;
+                    }
+                    planned[role][taker].insert(duty);
+                    moved.push_back({ taker, duty });
+                }
+                if (!emptied) {
+                    // Undo, this crew keeps its duties
+                    for (auto& move : moved) planned[role][move.first].erase(move.second.first);
+                    continue;
+                }
+                planned[role][crew].clear();
+                freed[crew] = true;
+                stats.crewsFreed++;
+            }
+        }
+    }
+
+public:
+    // Plans the missing crew of every Scheduled flight into roster, the days spread over pool
+    void plan(const Airline& airline, ThreadPool& pool, vector<pair<Crew*, Flight*>>& roster, RosterStats& stats) {
+        auto start = chrono::steady_clock::now();
+        auto guard = airline.readCatalog();
+        stats = RosterStats();
+        roster.clear();
+        places.clear();
+        for (int role = 0; role < CREW_ROLE_COUNT; role++) candidates[role].clear();
+
+        for (int role = 0; role < CREW_ROLE_COUNT; role++) {
+            candidates[role] = airline.getCrewPool().getCrews(static_cast<CrewRole>(role), CrewState::Available, true);
+            stats.eligible += candidates[role].size();
+            sort(candidates[role].begin(), candidates[role].end(), [](const Crew* a, const Crew* b) {
+                if ((a->getDutyCount() == 0) != (b->getDutyCount() == 0)) return a->getDutyCount() != 0;
+                return a->getId() < b->getId();
+            });
+        }
+
+        for (auto& entry : airline.getFlightsByStatus(FlightStatus::Scheduled)) {
+            Flight* flight = entry.second;
+            int missing[CREW_ROLE_COUNT];
+            copy(begin(CREW_MIX), end(CREW_MIX), missing);
+            for (Crew* crew : flight->getCrew()) {
+                CrewRole role;
+                if (convertStringToCrewRole(crew->getRole(), role)) missing[static_cast<int>(role)]--;
+            }
+            for (int role = 0; role < CREW_ROLE_COUNT; role++) {
+                for (int i = 0; i < missing[role]; i++) places.push_back(Place{ flight, flight->getDeparture(), role });
+            }
+        }
+        stable_sort(places.begin(), places.end(), [](const Place& a, const Place& b) { return a.start < b.start; });
+        stats.places = places.size();
+
+        dayStarts.clear();
+        for (size_t p = 0; p < places.size(); p++) {
+            if (!p || places[p].start / (24 * 60) != places[p - 1].start / (24 * 60)) dayStarts.push_back(p);
+        }
+        dayStarts.push_back(places.size());
+        stats.days = dayStarts.size() - 1;
+        for (int role = 0; role < CREW_ROLE_COUNT; role++) chains[role].assign(stats.days, vector<vector<size_t>>());
+        pool.run(stats.days, [this](size_t day) { chainDay(day); });
+
+        assignChains();
+        shedCrew(stats);
+
+        for (int role = 0; role < CREW_ROLE_COUNT; role++) {
+            for (size_t crew = 0; crew < candidates[role].size(); crew++) {
+                for (auto& duty : planned[role][crew]) roster.push_back({ candidates[role][crew], duty.second });
+                if (working(role, static_cast<int>(crew))) stats.crewsUsed++;
+            }
+        }
+        stats.filled = roster.size();
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+};
+
+// Results of a headless run of concurrent sessions
+struct SessionRunStats {
+    size_t bookings = 0; // Seats claimed
+    size_t soldOut = 0; // Bookings refused because the cabin was full
+    size_t cancellations = 0;
+    double seconds = 0;
+    bool inventoryConsistent = false; // Booked seats on the flights match the reservations held
+};
+
+// Runs sessionCount client sessions on their own threads, each registering a passenger and making
+// bookingsPerSession bookings on random open flights, giving every other seat back again
+SessionRunStats runSessions(Airline& airline, PricingTable& pricing, unsigned sessionCount, unsigned bookingsPerSession) {
+    SessionRunStats stats;
+    // Handles rather than pointers, a flight removed during the run is skipped instead of dangling
+    vector<PoolHandle> openFlights;
+    for (auto& entry : airline.getFlightsByStatus(FlightStatus::Scheduled)) openFlights.push_back(airline.getFlightHandle(entry.second));
+    if (openFlights.empty() || !sessionCount) return stats;
+
+    atomic<size_t> booked{ 0 }, soldOut{ 0 }, cancelled{ 0 };
+    auto start = chrono::steady_clock::now();
+    vector<thread> sessions;
+    for (unsigned s = 0; s < sessionCount; s++) {
+        sessions.emplace_back([&, s] {
+            mt19937 random(s + 1);
+            Passenger* passenger = airline.registerPassenger("session-" + to_string(s + 1));
+            for (unsigned b = 0; b < bookingsPerSession; b++) {
+                Flight* flight = airline.getFlight(openFlights[random() % openFlights.size()]);
+                if (!flight) continue;
+                SeatType seatType = static_cast<SeatType>(random() % CABIN_COUNT);
+                airline.quoteFare(flight, seatType, pricing);
+                if (airline.bookFlight(passenger, flight, seatType)) booked++;
+                else soldOut++;
+                if (b % 2 == 1 && !passenger->getReservations().empty()) {
+                    airline.cancelReservation(passenger, 0);
+                    cancelled++;
+                }
+            }
+        });
+    }
+    for (thread& session : sessions) session.join();
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.bookings = booked;
+    stats.soldOut = soldOut;
+    stats.cancellations = cancelled;
+
+    // Every seat taken on a flight must belong to exactly one reservation leg
+    size_t seatsTaken = 0, legsHeld = 0;
+    for (Flight* flight : airline.getFlights()) {
+        for (int cabin = 0; cabin < CABIN_COUNT; cabin++) seatsTaken += flight->getSeats().bookedSeats(static_cast<SeatType>(cabin));
+    }
+    for (Passenger* passenger : airline.getPassengers()) {
+        for (Reservation* reservation : passenger->getReservations()) legsHeld += reservation->getFlights().size();
+    }
+    stats.inventoryConsistent = seatsTaken == legsHeld;
+    // The flight table's seat columns must have followed every booking
+    const FlightTable& table = airline.getFlightTable();
+    for (uint32_t row = 0; row < table.size(); row++) {
+        for (int cabin = 0; cabin < CABIN_COUNT; cabin++) {
+            SeatType seatType = static_cast<SeatType>(cabin);
+            if (table.getFreeSeats(row, seatType) != table.getFlight(row)->getSeats().freeSeats(seatType)) stats.inventoryConsistent = false;
+        }
+    }
+    return stats;
+}
+
+// Returns the value following name on the command line, or fallback
+string commandLineValue(int argc, char* argv[], const string& name, const string& fallback) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (argv[i] == name) return argv[i + 1];
+    }
+    return fallback;
+}
+
+// Headless mode: --sessions <threads> [--bookings <per session>] [--journal <path>]
+int runSessionMode(int argc, char* argv[]) {
+    unsigned sessionCount = static_cast<unsigned>(atoi(commandLineValue(argc, argv, "--sessions", "4").c_str()));
+    unsigned bookings = static_cast<unsigned>(atoi(commandLineValue(argc, argv, "--bookings", "1000").c_str()));
+    string journalPath = commandLineValue(argc, argv, "--journal", "");
+
+    Airline airline("Headless");
+    FileHandler fileHandler("final_draft.txt");
+    fileHandler.readDataParallel(airline);
+    if (airline.getFlights().empty()) {
+        cerr << "Error: No flights loaded" << endl;
+        return 1;
+    }
+    RouteFactors defaultFactors;
+    defaultFactors.seasonalFactor = 1.2;
+    defaultFactors.demandFactor = 1.3;
+    PricingTable pricing(defaultFactors);
+    fileHandler.loadFactors(pricing, defaultFactors);
+
+    // With a journal every booking waits for its record to be durable, concurrent sessions share the syncs
+    Journal journal;
+    if (!journalPath.empty()) {
+        remove(journalPath.c_str());
+        if (!journal.open(journalPath, 0)) {
+            cerr << "Error: Unable to open journal " << journalPath << endl;
+            return 1;
+        }
+        airline.setJournal(&journal);
+    }
+
+    SessionRunStats stats = runSessions(airline, pricing, sessionCount, bookings);
+    size_t operations = stats.bookings + stats.soldOut + stats.cancellations;
+    cout << "Sessions        : " << sessionCount << "\n";
+    cout << "Bookings        : " << stats.bookings << " (" << stats.soldOut << " sold out)\n";
+    cout << "Cancellations   : " << stats.cancellations << "\n";
+    cout << "Time            : " << stats.seconds * 1000 << " ms\n";
+    cout << "Throughput      : " << (size_t)(stats.seconds > 0 ? operations / stats.seconds : 0) << " ops/s\n";
+    if (!journalPath.empty()) cout << "Journal syncs   : " << journal.getSyncCount() << " for " << journal.getLastSequence() << " records\n";
+    cout << "Inventory check : " << (stats.inventoryConsistent ? "OK" : "MISMATCH") << "\n";
+    airline.printMemoryUsage(cout);
+    return stats.inventoryConsistent ? 0 : 1;
+}
+
+// Stress mode: --stress <threads> [--rounds <n>] [--route <route>]
+// Every round all threads race to book one flight of the route until each cabin is sold out,
+// then the seats they got are checked for doubles and handed back for the next round
+int runStressMode(int argc, char* argv[]) {
+    unsigned threadCount = static_cast<unsigned>(atoi(commandLineValue(argc, argv, "--stress", "64").c_str()));
+    int rounds = atoi(commandLineValue(argc, argv, "--rounds", "50").c_str());
+    string route = commandLineValue(argc, argv, "--route", "NYC-LON");
+
+    Airline airline("Stress");
+    FileHandler fileHandler("final_draft.txt");
+    fileHandler.readDataParallel(airline);
+    if (airline.getFlightsByRoute(route).empty() || !threadCount) {
+        cerr << "Error: No flight on route " << route << endl;
+        return 1;
+    }
+    Flight* flight = airline.getFlightsByRoute(route)[0];
+    vector<Passenger*> racers;
+    for (unsigned t = 0; t < threadCount; t++) racers.push_back(airline.registerPassenger("racer-" + to_string(t + 1)));
+
+    size_t doubleBooked = 0, wrongTotals = 0, soldOut = 0;
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        atomic<size_t> refused{ 0 };
+        vector<thread> threads;
+        for (unsigned t = 0; t < threadCount; t++) {
+            threads.emplace_back([&, t] {
+                // Cycle through the cabins until none of them has a seat left
+                bool gotSeat = true;
+                while (gotSeat) {
+                    gotSeat = false;
+                    for (int cabin = 0; cabin < CABIN_COUNT; cabin++) {
+                        if (airline.bookFlight(racers[t], flight, static_cast<SeatType>(cabin))) gotSeat = true;
+                        else refused++;
+                    }
+                }
+            });
+        }
+        for (thread& racer : threads) racer.join();
+        soldOut += refused;
+
+        // Every seat of every cabin must have gone to exactly one racer
+        vector<vector<int>> holders(CABIN_COUNT);
+        for (int cabin = 0; cabin < CABIN_COUNT; cabin++) holders[cabin].assign(flight->getSeats().capacity(static_cast<SeatType>(cabin)), 0);
+        for (Passenger* racer : racers) {
+            for (Reservation* reservation : racer->getReservations()) {
+                holders[static_cast<int>(convertStringToSeatType(reservation->getSeat()))][reservation->getSeatNumbers()[0]]++;
+            }
+        }
+        for (int cabin = 0; cabin < CABIN_COUNT; cabin++) {
+            for (int holderCount : holders[cabin]) {
+                if (holderCount > 1) doubleBooked++;
+                if (holderCount != 1) wrongTotals++;
+            }
+        }
+        for (Passenger* racer : racers) {
+            while (!racer->getReservations().empty()) airline.cancelReservation(racer, static_cast<int>(racer->getReservations().size()) - 1);
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Threads         : " << threadCount << " on flight " << flight->getId() << " (" << route << ")\n";
+    cout << "Rounds          : " << rounds << " in " << seconds * 1000 << " ms\n";
+    cout << "Refused claims  : " << soldOut << "\n";
+    cout << "CAS retries     : " << flight->getSeats().getCasRetries() << "\n";
+    cout << "Sold out claims : " << flight->getSeats().getSoldOutClaims() << "\n";
+    cout << "Double booked   : " << doubleBooked << "\n";
+    cout << "Seat check      : " << (doubleBooked == 0 && wrongTotals == 0 ? "OK" : "FAILED") << "\n";
+    airline.printMemoryUsage(cout);
+    return doubleBooked == 0 && wrongTotals == 0 ? 0 : 1;
+}
+
+// Prints the outcome of a rostering run
+void printRosterStats(const RosterStats& stats, size_t assigned, ostream& out) {
+    out << "Crew places     : " << stats.places << " missing on Scheduled flights over " << stats.days << " days\n";
+    out << "Filled          : " << assigned << " (" << stats.places - stats.filled << " left open)\n";
+    out << "Crew used       : " << stats.crewsUsed << " of " << stats.eligible << " eligible\n";
+    out << "Local search    : " << stats.crewsFreed << " crew freed\n";
+    out << "Planned in      : " << stats.seconds * 1000 << " ms\n";
+}
+
+// Results of a re-accommodation run
+struct ReaccommodationStats {
+    size_t cancelledFlights = 0;
+    size_t affected = 0; // Reservations with a leg on a cancelled flight
+    size_t rebooked = 0;
+    size_t stranded = 0; // No connection in their cabin had a free seat
+    size_t retries = 0; // Connections that filled up between the search and the seat claim
+    size_t tiers = 0;
+    size_t passes = 0; // Searches of a tier, more than one when passengers ran out of options
+    double seconds = 0;
+};
+
+// ReaccommodationEngine class
+// Moves every reservation that uses a cancelled flight onto another connection between the
+// same airports, in the same cabin, departing no earlier than it was booked to. Passengers go
+// in priority tiers: loyalty eligible first, then First Class, Business and Economy, and by
+// departure within a tier, so a later tier only gets the seats an earlier one left. Each tier
+// is spread over the pool with one ItineraryPlanner per worker (search keeps scratch state),
+// built before every pass so full flights drop out. Seats are claimed lock-free through
+// Airline::rebookReservation; a passenger whose connection filled up meanwhile tries the next
+// one, and one who used up every option is searched again in another pass with fresh
+// planners. The journal is synced once at the end instead of once per passenger.
+class ReaccommodationEngine {
+private:
+    static const int MAX_STOPS = 2;
+    static const size_t OPTIONS = 8; // Connections tried per passenger, earliest arrival first
+    static const int MAX_PASSES = 3; // Searches per tier
+
+    struct Case {
+        Passenger* passenger;
+        Reservation* reservation;
+        SeatType seatType;
+        bool loyal;
+        uint32_t origin;
+        uint32_t destination;
+        int departure;
+    };
+
+    vector<Case> cases;
+    vector<ItineraryPlanner> planners; // One per worker
+
+    // Reservations of the flights' passengers with a leg on any of them, each once
+    void collectCases(const vector<Flight*>& cancelled) {
+        cases.clear();
+        unordered_set<Flight*> cancelledSet(cancelled.begin(), cancelled.end());
+        vector<Passenger*> passengers;
+        for (Flight* flight : cancelled) {
+            lock_guard<mutex> guard(flight->getLock());
+            passengers.insert(passengers.end(), flight->getPassengers().begin(), flight->getPassengers().end());
+        }
+        sort(passengers.begin(), passengers.end());
+        passengers.erase(unique(passengers.begin(), passengers.end()), passengers.end());
+        for (Passenger* passenger : passengers) {
+            lock_guard<mutex> guard(passenger->getLock());
+            for (Reservation* reservation : passenger->getReservations()) {
+                const vector<Flight*>& legs = reservation->getFlights();
+                bool hit = false;
+                for (Flight* leg : legs) hit = hit || cancelledSet.count(leg);
+                if (!hit) continue;
+                cases.push_back(Case{ passenger, reservation, convertStringToSeatType(reservation->getSeat()), passenger->getEligibility(),
+                    legs.front()->getOrigin(), legs.back()->getDestination(), legs.front()->getDeparture() });
+            }
+        }
+        stable_sort(cases.begin(), cases.end(), [](const Case& a, const Case& b) {
+            if (a.loyal != b.loyal) return a.loyal;
+            if (a.seatType != b.seatType) return a.seatType > b.seatType;
+            if (a.departure != b.departure) return a.departure < b.departure;
+            return a.passenger->getName() < b.passenger->getName();
+        });
+    }
+
+public:
+    // Re-accommodates the passengers of the cancelled flights, the tiers spread over pool
+    void run(Airline& airline, const vector<Flight*>& cancelled, PricingTable& pricing, ThreadPool& pool, ReaccommodationStats& stats) {
+        auto start = chrono::steady_clock::now();
+        stats = ReaccommodationStats();
+        stats.cancelledFlights = cancelled.size();
+        collectCases(cancelled);
+        stats.affected = cases.size();
+        planners.resize(pool.size());
+
+        atomic<size_t> rebooked{ 0 }, retries{ 0 };
+        vector<vector<size_t>> unlucky(planners.size()); // Per worker, passengers who used up every option
+        vector<size_t> pending;
+        for (size_t first = 0; first < cases.size();) {
+            size_t last = first;
+            while (last < cases.size() && cases[last].loyal == cases[first].loyal && cases[last].seatType == cases[first].seatType) last++;
+            SeatType seatType = cases[first].seatType;
+            pending.clear();
+            for (size_t c = first; c < last; c++) pending.push_back(c);
+            for (int pass = 0; pass < MAX_PASSES && !pending.empty(); pass++) {
+                pool.run(planners.size(), [&](size_t worker) { planners[worker].build(airline, seatType, pricing); });
+                // Worker w takes every planners.size()-th passenger, so each worker runs down the whole tier in priority order
+                pool.run(planners.size(), [&](size_t worker) {
+                    vector<Itinerary> found;
+                    unlucky[worker].clear();
+                    for (size_t p = worker; p < pending.size(); p += planners.size()) {
+                        const Case& item = cases[pending[p]];
+                        planners[worker].search(item.origin, item.destination, item.departure, MAX_STOPS, ItineraryOrder::Arrival, OPTIONS, found);
+                        bool placed = false;
+                        for (size_t i = 0; i < found.size() && !placed; i++) {
+                            placed = airline.rebookReservation(item.passenger, item.reservation, found[i].legs, false);
+                            if (!placed) retries++;
+                        }
+                        if (placed) rebooked++;
+                        // Fewer options than asked for means there are no others to try
+                        else if (found.size() == OPTIONS) unlucky[worker].push_back(pending[p]);
+                    }
+                });
+                pending.clear();
+                for (const vector<size_t>& missed : unlucky) pending.insert(pending.end(), missed.begin(), missed.end());
+                sort(pending.begin(), pending.end());
+                stats.passes++;
+            }
+            stats.tiers++;
+            first = last;
+        }
+        airline.syncJournal();
+        stats.rebooked = rebooked;
+        stats.stranded = stats.affected - stats.rebooked;
+        stats.retries = retries;
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+};
+
+void printReaccommodationStats(const ReaccommodationStats& stats, ostream& out) {
+    out << "Cancelled       : " << stats.cancelledFlights << " flights, " << stats.affected << " reservations affected\n";
+    out << "Rebooked        : " << stats.rebooked << " (" << stats.stranded << " stranded, " << stats.retries << " connections found full)\n";
+    out << "Rebooked in     : " << stats.seconds * 1000 << " ms over " << stats.tiers << " priority tiers, " << stats.passes << " passes\n";
+}
+
+// Roster mode: --roster [--threads <n>]
+// Fills the crew of every Scheduled flight, then checks the whole roster for clashes
+int runRosterMode(int argc, char* argv[]) {
+    unsigned threadCount = static_cast<unsigned>(atoi(commandLineValue(argc, argv, "--threads", "0").c_str()));
+
+    Airline airline("Roster");
+    FileHandler fileHandler("final_draft.txt");
+    fileHandler.readDataParallel(airline);
+    ThreadPool pool(threadCount);
+    RosterSolver solver;
+    vector<pair<Crew*, Flight*>> roster;
+    RosterStats stats;
+    solver.plan(airline, pool, roster, stats);
+    size_t assigned = airline.applyRoster(roster);
+
+    vector<DutyViolation> violations;
+    airline.validateRoster(violations);
+    printRosterStats(stats, assigned, cout);
+    cout << "Roster check    : " << (violations.empty() ? "OK" : to_string(violations.size()) + " clashes") << "\n";
+    return violations.empty() ? 0 : 1;
+}
+
+// Quotes text as a JSON string
+string jsonString(string_view text) {
+    string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+            quoted += escape;
+        }
+        else quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Results of a script run
+struct ScriptStats {
+    size_t commands = 0;
+    size_t succeeded = 0;
+    size_t failed = 0;
+    double seconds = 0;
+};
+
+// ScriptRunner class
+// Runs the operations of the menus from text commands, one per line, so they can be automated
+// and recorded traffic can be replayed. Every command gets one JSON object on one line back:
+//   book <passenger> <flight id> <Economy|Business|FirstClass>   registers a new passenger
+//   cancel <passenger> <flight id>           the passenger's first reservation with that flight
+//   modify <passenger> <flight id> <cabin>
+//   assign <flight id> <crew id>
+//   unassign <flight id> <crew id>
+//   status <flight id> <Scheduled|Delayed|Cancelled>         cancelling rebooks the passengers
+//   reroute <flight id> <route>
+//   retime <flight id> <minutes after midnight of Day 1>
+//   add <route> <minutes after midnight of Day 1>
+// Arguments are separated by spaces or tabs and a name with spaces goes in double quotes.
+// Blank lines and lines starting with # are skipped. Commands run one at a time in input
+// order, so a script gives the same results every time it is replayed on the same data.
+class ScriptRunner {
+private:
+    Airline& airline;
+    PricingTable& pricing;
+    ThreadPool pool; // Rebooks the passengers of cancelled flights
+    ReaccommodationEngine engine;
+    vector<string_view> args;
+    string result; // JSON object of the command being run
+
+    // Splits the line at spaces and tabs, returns false on an unterminated quote
+    bool tokenize(string_view line) {
+        args.clear();
+        size_t i = 0;
+        while (i < line.size()) {
+            if (line[i] == ' ' || line[i] == '\t') {
+                i++;
+                continue;
+            }
+            if (line[i] == '"') {
+                size_t end = line.find('"', i + 1);
+                if (end == string_view::npos) return false;
+                args.push_back(line.substr(i + 1, end - i - 1));
+                i = end + 1;
+                continue;
+            }
+            size_t end = i;
+            while (end < line.size() && line[end] != ' ' && line[end] != '\t') end++;
+            args.push_back(line.substr(i, end - i));
+            i = end;
+        }
+        return true;
+    }
+
+    static bool parseNumber(string_view text, int& value) {
+        bool negative = !text.empty() && text[0] == '-';
+        if (negative) text.remove_prefix(1);
+        if (text.empty() || text.size() > 9) return false;
+        value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + (c - '0');
+        }
+        if (negative) value = -value;
+        return true;
+    }
+
+    static bool parseSeatType(string_view text, SeatType& seatType) {
+        for (int cabin = 0; cabin < CABIN_COUNT; cabin++) {
+            if (text == convertSeatTypeToString(static_cast<SeatType>(cabin))) {
+                seatType = static_cast<SeatType>(cabin);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void addField(const char* name, string_view value) {
+        result += ",\"";
+        result += name;
+        result += "\":";
+        result += jsonString(value);
+    }
+
+    void addField(const char* name, long long value) {
+        result += ",\"";
+        result += name;
+        result += "\":";
+        result += to_string(value);
+    }
+
+    bool fail(string_view error) {
+        result += ",\"ok\":false";
+        addField("error", error);
+        return false;
+    }
+
+    bool succeed() {
+        result += ",\"ok\":true";
+        return true;
+    }
+
+    Flight* flightArgument(size_t i) {
+        int id;
+        return parseNumber(args[i], id) ? airline.getFlightById(id) : nullptr;
+    }
+
+    // Index of the passenger's first reservation with a leg on the flight, or -1
+    static int findReservation(Passenger* passenger, Flight* flight) {
+        vector<Reservation*>& reservations = passenger->getReservations();
+        for (int i = 0; i < static_cast<int>(reservations.size()); i++) {
+            const vector<Flight*>& legs = reservations[i]->getFlights();
+            if (find(legs.begin(), legs.end(), flight) != legs.end()) return i;
+        }
+        return -1;
+    }
+
+    bool run() {
+        static const struct {
+            const char* name;
+            size_t argCount;
+        } COMMANDS[] = {
+            { "book", 3 }, { "cancel", 2 }, { "modify", 3 }, { "assign", 2 }, { "unassign", 2 },
+            { "status", 2 }, { "reroute", 2 }, { "retime", 2 }, { "add", 2 }
+        };
+        string_view op = args[0];
+        bool known = false;
+        for (const auto& command : COMMANDS) {
+            if (op != command.name) continue;
+            if (args.size() != command.argCount + 1) return fail("expected " + to_string(command.argCount) + " arguments");
+            known = true;
+        }
+        if (!known) return fail("unknown command");
+
+        if (op == "add") {
+            int departure;
+            if (!parseNumber(args[2], departure) || departure < 0) return fail("invalid time");
+            Flight* flight = airline.scheduleFlight(string(args[1]), departure);
+            if (!flight) return fail("invalid route");
+            addField("flight", flight->getId());
+            return succeed();
+        }
+
+        if (op == "book" || op == "cancel" || op == "modify") {
+            Flight* flight = flightArgument(2);
+            if (!flight) return fail("unknown flight");
+            addField("flight", flight->getId());
+            SeatType seatType = SeatType::Economy;
+            if (op != "cancel" && !parseSeatType(args[3], seatType)) return fail("invalid cabin");
+            string name(args[1]);
+            if (op == "book") {
+                if (flight->getStatus() != FlightStatus::Scheduled) return fail("flight is not Scheduled");
+                Reservation* reservation = airline.bookFlight(airline.registerPassenger(name), flight, seatType);
+                if (!reservation) return fail("sold out");
+                addField("seat", reservation->getSeat());
+                addField("seatNo", reservation->getSeatNumbers()[0] + 1);
+                return succeed();
+            }
+            Passenger* passenger = airline.findPassenger(name);
+            if (!passenger) return fail("unknown passenger");
+            int idx = findReservation(passenger, flight);
+            if (idx < 0) return fail("no reservation on flight");
+            if (op == "cancel") {
+                airline.cancelReservation(passenger, idx);
+                return succeed();
+            }
+            if (!airline.modifyReservation(passenger, idx, seatType)) return fail("sold out");
+            return succeed();
+        }
+
+        Flight* flight = flightArgument(1);
+        if (!flight) return fail("unknown flight");
+        addField("flight", flight->getId());
+
+        if (op == "assign" || op == "unassign") {
+            int crewId;
+            Crew* crew = parseNumber(args[2], crewId) ? airline.getCrewById(crewId) : nullptr;
+            if (!crew) return fail("unknown crew");
+            if (op == "assign") {
+                DutyConflict conflict = airline.assignCrewToFlight(flight, crew);
+                if (conflict == DutyConflict::Overlap) return fail("overlaps another duty");
+                if (conflict == DutyConflict::ShortRest) return fail("too little rest between duties");
+                return succeed();
+            }
+            const vector<Crew*>& onBoard = flight->getCrew();
+            int idx = static_cast<int>(find(onBoard.begin(), onBoard.end(), crew) - onBoard.begin());
+            if (static_cast<size_t>(idx) == onBoard.size()) return fail("crew not on flight");
+            airline.removeCrewFromFlight(flight, idx);
+            return succeed();
+        }
+        if (op == "status") {
+            FlightStatus status;
+            if (!convertStringToFlightStatus(args[2], status)) return fail("invalid status");
+            FlightStatus oldStatus = flight->getStatus();
+            if (!airline.setFlightStatus(flight, status)) return fail("transition not allowed");
+            if (status == FlightStatus::Cancelled && oldStatus != status) {
+                ReaccommodationStats stats;
+                engine.run(airline, { flight }, pricing, pool, stats);
+                addField("rebooked", stats.rebooked);
+                addField("stranded", stats.stranded);
+            }
+            return succeed();
+        }
+        if (op == "reroute") {
+            if (!airline.rerouteFlight(flight, string(args[2]))) return fail("invalid route");
+            return succeed();
+        }
+        int departure;
+        if (!parseNumber(args[2], departure) || departure < 0) return fail("invalid time");
+        airline.setFlightTime(flight, departure);
+        vector<DutyViolation> conflicts;
+        airline.handleScheduleConflicts(flight, conflicts);
+        addField("crewConflicts", conflicts.size());
+        return succeed();
+    }
+
+public:
+    ScriptRunner(Airline& airline, PricingTable& pricing, unsigned threadCount = 0)
+        : airline(airline), pricing(pricing), pool(threadCount) {}
+
+    // Runs one line, appending its JSON result and a newline to out; skipped lines add nothing
+    void execute(string_view line, size_t lineNo, string& out, ScriptStats& stats) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        result = "{\"line\":" + to_string(lineNo);
+        bool ok;
+        if (!tokenize(line)) {
+            result += ",\"op\":" + jsonString(args.empty() ? string_view() : args[0]);
+            ok = fail("unterminated quote");
+        }
+        else {
+            if (args.empty() || (!args[0].empty() && args[0][0] == '#')) return;
+            result += ",\"op\":" + jsonString(args[0]);
+            ok = run();
+        }
+        stats.commands++;
+        if (ok) stats.succeeded++;
+        else stats.failed++;
+        out += result;
+        out += "}\n";
+    }
+
+    // Runs every line of in, writing the results to out in blocks. A journal attached with
+    // waitForEachCommit false is synced before each block, so a result is only written once
+    // its change is durable and one sync covers the whole block.
+    void executeAll(istream& in, ostream& out, ScriptStats& stats) {
+        auto start = chrono::steady_clock::now();
+        stats = ScriptStats();
+        string line, buffer;
+        size_t lineNo = 0;
+        while (getline(in, line)) {
+            execute(line, ++lineNo, buffer, stats);
+            if (buffer.size() >= 1 << 16) {
+                airline.syncJournal();
+                out.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        }
+        airline.syncJournal();
+        out.write(buffer.data(), buffer.size());
+        out.flush();
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+};
+
+// Script mode: --script [<path>] [--schedule <path>] [--journal <path>] [--threads <n>]
+// Runs the commands of the file (or stdin when no path or "-" is given) against the schedule
+// file (final_draft.txt by default), results go to stdout as JSON lines and a summary to stderr
+int runScriptMode(int argc, char* argv[]) {
+    string scriptPath = commandLineValue(argc, argv, "--script", "-");
+    if (scriptPath.rfind("--", 0) == 0) scriptPath = "-";
+    string journalPath = commandLineValue(argc, argv, "--journal", "");
+    unsigned threadCount = static_cast<unsigned>(atoi(commandLineValue(argc, argv, "--threads", "0").c_str()));
+    string schedulePath = commandLineValue(argc, argv, "--schedule", "final_draft.txt");
+    ios::sync_with_stdio(false);
+
+    ifstream scriptFile;
+    if (scriptPath != "-") {
+        scriptFile.open(scriptPath);
+        if (!scriptFile.is_open()) {
+            cerr << "Error: Unable to open script " << scriptPath << endl;
+            return 1;
+        }
+    }
+
+    Airline airline("Script");
+    FileHandler fileHandler(schedulePath);
+    fileHandler.readDataParallel(airline);
+    RouteFactors defaultFactors;
+    defaultFactors.seasonalFactor = 1.2;
+    defaultFactors.demandFactor = 1.3;
+    PricingTable pricing(defaultFactors);
+    fileHandler.loadFactors(pricing, defaultFactors);
+
+    Journal journal;
+    if (!journalPath.empty()) {
+        remove(journalPath.c_str());
+        if (!journal.open(journalPath, 0)) {
+            cerr << "Error: Unable to open journal " << journalPath << endl;
+            return 1;
+        }
+        airline.setJournal(&journal, false);
+    }
+
+    ScriptRunner runner(airline, pricing, threadCount);
+    ScriptStats stats;
+    runner.executeAll(scriptPath == "-" ? cin : scriptFile, cout, stats);
+    cerr << "Commands        : " << stats.commands << " (" << stats.succeeded << " succeeded, " << stats.failed << " failed)\n";
+    cerr << "Time            : " << stats.seconds * 1000 << " ms\n";
+    cerr << "Throughput      : " << (size_t)(stats.seconds > 0 ? stats.commands / stats.seconds : 0) << " commands/s\n";
+    if (!journalPath.empty()) cerr << "Journal syncs   : " << journal.getSyncCount() << " for " << journal.getLastSequence() << " records\n";
+    return 0;
+}
+
+// Next number of a splitmix64 sequence, cheap enough to draw a few for every generated row
+uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// ZipfSampler class
+// Draws 0 .. count - 1 with probability proportional to 1 / (i + 1)^skew in O(1) using
+// Vose's alias method, a skew of 0 draws uniformly
+class ZipfSampler {
+private:
+    vector<double> threshold;
+    vector<uint32_t> alias;
+
+public:
+    ZipfSampler(size_t count = 1, double skew = 0) {
+        count = max<size_t>(1, count);
+        threshold.assign(count, 1);
+        alias.resize(count);
+        for (size_t i = 0; i < count; i++) alias[i] = static_cast<uint32_t>(i);
+        if (skew <= 0) return;
+
+        vector<double> weight(count);
+        double total = 0;
+        for (size_t i = 0; i < count; i++) total += weight[i] = pow(i + 1.0, -skew);
+        vector<uint32_t> small, large;
+        for (size_t i = 0; i < count; i++) {
+            weight[i] *= count / total;
+            (weight[i] < 1 ? small : large).push_back(static_cast<uint32_t>(i));
+        }
+        // Each small slot is topped up by a large one, leftovers are 1 up to rounding
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back();
+            uint32_t l = large.back();
+            small.pop_back();
+            threshold[s] = weight[s];
+            alias[s] = l;
+            weight[l] -= 1 - weight[s];
+            if (weight[l] < 1) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+    }
+
+    size_t size() const { return threshold.size(); }
+
+    // The high half of random picks the slot, the low half decides between it and its alias
+    uint32_t draw(uint64_t random) const {
+        uint32_t slot = static_cast<uint32_t>(((random >> 32) * threshold.size()) >> 32);
+        return (random & 0xFFFFFFFF) * (1.0 / 4294967296.0) < threshold[slot] ? slot : alias[slot];
+    }
+};
+
+// Settings of ScheduleGenerator, the same settings always generate the same files
+struct GeneratorConfig {
+    size_t flights = 37; // Rows of the schedule
+    uint64_t seed = 1;
+    uint32_t airports = 0; // 0 picks about 2 * sqrt(flights), at most every three letter code
+    double airportSkew = 0; // Zipf exponent of airport popularity, 0 is uniform
+    double routeSkew = 1; // Zipf exponent of route demand in traffic, 0 is uniform
+    unsigned threadCount = 0; // 0 uses one thread per hardware core
+};
+
+// One generated schedule row
+struct SyntheticRow {
+    uint32_t origin;
+    uint32_t destination;
+    FlightStatus status;
+    const char* crewRole;
+    bool crewCompliance;
+    bool crewAvailable;
+};
+
+// ScheduleGenerator class
+// Writes synthetic schedules in the final_draft.txt format, route factors in the
+// pricing_factors.txt format and booking traffic as script mode commands.
+// Both ends of a route are drawn by airport popularity, so with a skew the popular airports
+// become hubs joined by the busiest routes. Traffic books mostly on the hot routes: routes are
+// ranked by their number of Scheduled flights and drawn by rank from a Zipf distribution.
+// Each block of rows has its own random sequence, so blocks are generated in parallel and the
+// output depends only on the config, never on the thread count.
+class ScheduleGenerator {
+private:
+    static constexpr size_t BLOCK_ROWS = 1 << 16;
+
+    GeneratorConfig config;
+    vector<char> codes; // Three letters per airport, in a seeded order so hubs aren't alphabetical
+    ZipfSampler airports;
+
+    // Scheduled flights as (route, row) sorted by route, and the routes as (first, count)
+    // ranges of flights, busiest first
+    struct RouteIndex {
+        vector<pair<uint32_t, uint32_t>> flights;
+        vector<pair<size_t, size_t>> ranked;
+    };
+
+    size_t blockCount() const {
+        return (config.flights + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    }
+
+    // Calls onRow(row, generated) for every row of the block, in order
+    template <typename RowFn>
+    void forEachRowOfBlock(size_t block, RowFn onRow) const {
+        static const char* ROLES[] = { "Pilot", "CoPilot", "FlightAttendant", "FlightAttendant" };
+        static const FlightStatus STATUSES[] = {
+            FlightStatus::Scheduled, FlightStatus::Scheduled, FlightStatus::Scheduled, FlightStatus::Scheduled,
+            FlightStatus::Scheduled, FlightStatus::Scheduled, FlightStatus::Scheduled, FlightStatus::Scheduled,
+            FlightStatus::Delayed, FlightStatus::Cancelled
+        };
+        uint64_t state = config.seed ^ (block * 0xD1B54A32D192ED03ULL);
+        state = splitMix64(state);
+        size_t end = min(config.flights, (block + 1) * BLOCK_ROWS);
+        SyntheticRow generated;
+        for (size_t row = block * BLOCK_ROWS; row < end; row++) {
+            generated.origin = airports.draw(splitMix64(state));
+            do generated.destination = airports.draw(splitMix64(state));
+            while (generated.destination == generated.origin);
+            uint64_t draw = splitMix64(state);
+            generated.status = STATUSES[draw % 10];
+            generated.crewRole = ROLES[(draw >> 8) % 4];
+            generated.crewCompliance = (draw >> 16) % 10 != 0;
+            generated.crewAvailable = (draw >> 24) % 8 != 0;
+            onRow(row, generated);
+        }
+    }
+
+    void appendRoute(string& out, uint32_t origin, uint32_t destination) const {
+        out.append(&codes[origin * 3], 3);
+        out += '-';
+        out.append(&codes[destination * 3], 3);
+    }
+
+    static void appendNumber(string& out, uint64_t value) {
+        char digits[20];
+        int length = 0;
+        do {
+            digits[length++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value);
+        while (length) out += digits[--length];
+    }
+
+    // Writes hundredths as a decimal with two places
+    static void appendHundredths(string& out, uint64_t hundredths) {
+        appendNumber(out, hundredths / 100);
+        out += '.';
+        out += static_cast<char>('0' + hundredths / 10 % 10);
+        out += static_cast<char>('0' + hundredths % 10);
+    }
+
+    static const char* cabinName(uint64_t draw) {
+        // 80% Economy, 15% Business, 5% FirstClass
+        draw %= 20;
+        return draw < 16 ? "Economy" : draw < 19 ? "Business" : "FirstClass";
+    }
+
+    void buildRouteIndex(RouteIndex& index) const {
+        uint32_t airportCount = static_cast<uint32_t>(airports.size());
+        vector<vector<pair<uint32_t, uint32_t>>> blocks(blockCount());
+        ThreadPool pool(config.threadCount);
+        pool.run(blocks.size(), [&](size_t block) {
+            forEachRowOfBlock(block, [&](size_t row, const SyntheticRow& generated) {
+                if (generated.status != FlightStatus::Scheduled) return;
+                blocks[block].push_back(make_pair(generated.origin * airportCount + generated.destination, static_cast<uint32_t>(row)));
+            });
+        });
+        size_t total = 0;
+        for (size_t b = 0; b < blocks.size(); b++) total += blocks[b].size();
+        index.flights.clear();
+        index.flights.reserve(total);
+        for (size_t b = 0; b < blocks.size(); b++) {
+            index.flights.insert(index.flights.end(), blocks[b].begin(), blocks[b].end());
+            vector<pair<uint32_t, uint32_t>>().swap(blocks[b]);
+        }
+        sort(index.flights.begin(), index.flights.end());
+
+        index.ranked.clear();
+        for (size_t first = 0; first < index.flights.size();) {
+            size_t last = first;
+            while (last < index.flights.size() && index.flights[last].first == index.flights[first].first) last++;
+            index.ranked.push_back(make_pair(first, last - first));
+            first = last;
+        }
+        // Ties keep route order, which the stable sort preserves
+        stable_sort(index.ranked.begin(), index.ranked.end(),
+            [](const pair<size_t, size_t>& a, const pair<size_t, size_t>& b) { return a.second > b.second; });
+    }
+
+public:
+    explicit ScheduleGenerator(const GeneratorConfig& settings) : config(settings) {
+        const uint32_t maxAirports = 26 * 26 * 26;
+        uint32_t airportCount = config.airports;
+        if (!airportCount) airportCount = static_cast<uint32_t>(min<size_t>(maxAirports, max<size_t>(8, static_cast<size_t>(sqrt(static_cast<double>(config.flights)) * 2))));
+        airportCount = max<uint32_t>(2, min(maxAirports, airportCount));
+        config.airports = airportCount;
+        airports = ZipfSampler(airportCount, config.airportSkew);
+
+        // Fisher-Yates over every code, so the codes are the same on every standard library
+        vector<uint32_t> order(maxAirports);
+        for (uint32_t i = 0; i < maxAirports; i++) order[i] = i;
+        uint64_t state = config.seed;
+        for (uint32_t i = maxAirports - 1; i > 0; i--) swap(order[i], order[splitMix64(state) % (i + 1)]);
+        codes.resize(airportCount * 3);
+        for (uint32_t airport = 0; airport < airportCount; airport++) {
+            codes[airport * 3] = static_cast<char>('A' + order[airport] / 676);
+            codes[airport * 3 + 1] = static_cast<char>('A' + order[airport] / 26 % 26);
+            codes[airport * 3 + 2] = static_cast<char>('A' + order[airport] % 26);
+        }
+    }
+
+    const GeneratorConfig& getConfig() const {
+        return config;
+    }
+
+    // "route,state,crewName,crewRole,compliance,crewState" for every flight, crew "Crew <row>".
+    // 80% of flights are Scheduled, 10% Delayed and 10% Cancelled
+    bool writeSchedule(ostream& out) const {
+        ThreadPool pool(config.threadCount);
+        size_t blocks = blockCount();
+        size_t batch = pool.size() * 2;
+        vector<string> text(batch);
+        for (size_t first = 0; first < blocks; first += batch) {
+            size_t count = min(batch, blocks - first);
+            pool.run(count, [&](size_t i) {
+                string& buffer = text[i];
+                buffer.clear();
+                forEachRowOfBlock(first + i, [&](size_t row, const SyntheticRow& generated) {
+                    appendRoute(buffer, generated.origin, generated.destination);
+                    buffer += ',';
+                    buffer += FlightState::forStatus(generated.status)->getName();
+                    buffer += ",Crew ";
+                    appendNumber(buffer, row + 1);
+                    buffer += ',';
+                    buffer += generated.crewRole;
+                    buffer += generated.crewCompliance ? ",1," : ",0,";
+                    buffer += generated.crewAvailable ? "Available\n" : "Training\n";
+                });
+            });
+            for (size_t i = 0; i < count; i++) out.write(text[i].data(), text[i].size());
+            if (!out) return false;
+        }
+        return out.flush().good();
+    }
+
+    // Factors of the routeCount busiest routes of the schedule: a base price of 100-199, demand
+    // from 1.50 on the busiest route down to 1.00, seasonal 1.00-1.29 and an event on 1 in 20
+    bool writeFactors(ostream& out, size_t routeCount) const {
+        RouteIndex index;
+        buildRouteIndex(index);
+        routeCount = min(routeCount, index.ranked.size());
+        string buffer = "# route,basePrice,demandFactor,seasonalFactor,eventFactor\n"
+                        "# A basePrice of 0 keeps each flight's own price, the route * applies to every route without a row\n"
+                        "*,0,1.3,1.2,1\n";
+        uint64_t state = config.seed ^ 0xFAC7042500000000ULL;
+        uint32_t airportCount = static_cast<uint32_t>(airports.size());
+        for (size_t rank = 0; rank < routeCount; rank++) {
+            uint32_t route = index.flights[index.ranked[rank].first].first;
+            uint64_t draw = splitMix64(state);
+            appendRoute(buffer, route / airportCount, route % airportCount);
+            buffer += ',';
+            appendNumber(buffer, 100 + draw % 100);
+            buffer += ',';
+            appendHundredths(buffer, 150 - rank * 50 / routeCount);
+            buffer += ',';
+            appendHundredths(buffer, 100 + (draw >> 8) % 30);
+            buffer += (draw >> 16) % 20 ? ",1\n" : ",1.5\n";
+            if (buffer.size() >= 1 << 20) {
+                out.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        }
+        out.write(buffer.data(), buffer.size());
+        return out.flush().good();
+    }
+
+    // commandCount script commands against the schedule loaded into a fresh airline, where flight
+    // row r has id r + 1: 80% book a new passenger "P<n>" on a Scheduled flight of a route drawn by
+    // rank, 12% cancel and 8% modify a reservation still held. Cabins are 80% Economy,
+    // 15% Business and 5% FirstClass.
+    bool writeTraffic(ostream& out, size_t commandCount) const {
+        RouteIndex index;
+        buildRouteIndex(index);
+        string buffer = "# traffic seed " + to_string(config.seed) + " for " + to_string(config.flights) + " flights\n";
+        if (index.ranked.empty()) {
+            out.write(buffer.data(), buffer.size());
+            return out.flush().good();
+        }
+        ZipfSampler routes(index.ranked.size(), config.routeSkew);
+        vector<pair<uint64_t, uint32_t>> held; // (passenger, row) of the reservations not cancelled
+        uint64_t passengers = 0;
+        uint64_t state = config.seed ^ 0x7AFF1C0000000000ULL;
+        for (size_t c = 0; c < commandCount; c++) {
+            uint64_t draw = splitMix64(state);
+            uint64_t pick = splitMix64(state);
+            unsigned kind = static_cast<unsigned>(draw % 100);
+            if (held.empty() || kind < 80) {
+                const pair<size_t, size_t>& route = index.ranked[routes.draw(pick)];
+                uint32_t row = index.flights[route.first + (draw >> 32) % route.second].second;
+                held.push_back(make_pair(++passengers, row));
+                buffer += "book P";
+                appendNumber(buffer, passengers);
+                buffer += ' ';
+                appendNumber(buffer, row + 1ULL);
+                buffer += ' ';
+                buffer += cabinName(draw >> 8);
+                buffer += '\n';
+            }
+            else {
+                size_t i = pick % held.size();
+                buffer += kind < 92 ? "cancel P" : "modify P";
+                appendNumber(buffer, held[i].first);
+                buffer += ' ';
+                appendNumber(buffer, held[i].second + 1ULL);
+                if (kind < 92) {
+                    held[i] = held.back();
+                    held.pop_back();
+                }
+                else {
+                    buffer += ' ';
+                    buffer += cabinName(draw >> 8);
+                }
+                buffer += '\n';
+            }
+            if (buffer.size() >= 1 << 20) {
+                out.write(buffer.data(), buffer.size());
+                buffer.clear();
+                if (!out) return false;
+            }
+        }
+        out.write(buffer.data(), buffer.size());
+        return out.flush().good();
+    }
+};
+
+// Generate mode: --generate <schedule|factors|traffic> [--rows <n>] [--flights <n>] [--seed <n>]
+//     [--airports <n>] [--airport-skew <s>] [--route-skew <s>] [--threads <n>] [--output <path>]
+// schedule writes --rows flights. factors writes the --rows busiest routes and traffic --rows
+// commands, both for the schedule of --flights rows (default --rows) with the same seed and
+// airports. Output goes to stdout unless a path is given, a summary to stderr.
+int runGenerateMode(int argc, char* argv[]) {
+    string kind = commandLineValue(argc, argv, "--generate", "schedule");
+    string rowText = commandLineValue(argc, argv, "--rows", "37");
+    size_t rows = static_cast<size_t>(atoll(rowText.c_str()));
+    GeneratorConfig config;
+    config.flights = kind == "schedule" ? rows : static_cast<size_t>(atoll(commandLineValue(argc, argv, "--flights", rowText).c_str()));
+    config.seed = static_cast<uint64_t>(atoll(commandLineValue(argc, argv, "--seed", "1").c_str()));
+    config.airports = static_cast<uint32_t>(atoi(commandLineValue(argc, argv, "--airports", "0").c_str()));
+    config.airportSkew = atof(commandLineValue(argc, argv, "--airport-skew", "0").c_str());
+    config.routeSkew = atof(commandLineValue(argc, argv, "--route-skew", "1").c_str());
+    config.threadCount = static_cast<unsigned>(atoi(commandLineValue(argc, argv, "--threads", "0").c_str()));
+    string outputPath = commandLineValue(argc, argv, "--output", "-");
+    if (kind != "schedule" && kind != "factors" && kind != "traffic") {
+        cerr << "Error: Unknown output " << kind << ", expected schedule, factors or traffic" << endl;
+        return 1;
+    }
+    ios::sync_with_stdio(false);
+
+    ofstream file;
+    if (outputPath != "-") {
+        file.open(outputPath, ios::binary);
+        if (!file.is_open()) {
+            cerr << "Error: Unable to write " << outputPath << endl;
+            return 1;
+        }
+    }
+    ostream& out = outputPath == "-" ? cout : file;
+
+    auto start = chrono::steady_clock::now();
+    ScheduleGenerator generator(config);
+    bool written = kind == "schedule" ? generator.writeSchedule(out)
+        : kind == "factors" ? generator.writeFactors(out, rows)
+        : generator.writeTraffic(out, rows);
+    if (!written) {
+        cerr << "Error: Unable to write " << outputPath << endl;
+        return 1;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << "Generated       : " << rows << " " << kind << " rows for " << config.flights << " flights and "
+         << generator.getConfig().airports << " airports\n";
+    cerr << "Time            : " << seconds * 1000 << " ms (" << (size_t)(seconds > 0 ? rows / seconds : 0) << " rows/s)\n";
+    return 0;
+}
+
+// Results of one benchmark of runBenchMode
+struct BenchResult {
+    string name;
+    size_t flights = 0;
+    size_t ops = 0; // Timed operations
+    size_t items = 0; // Rows, flights or fares handled by all the ops together
+    size_t refused = 0; // Ops turned down, e.g. a booking on a sold out cabin
+    double seconds = 0;
+    vector<uint64_t> latencies; // Nanoseconds of each op
+};
+
+// Runs op(0) .. op(count - 1), timing each one; op returns false when it was refused
+template <typename Op>
+void timeBenchOps(BenchResult& result, size_t count, size_t itemsPerOp, Op op) {
+    result.latencies.reserve(result.latencies.size() + count);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        auto before = chrono::steady_clock::now();
+        if (!op(i)) result.refused++;
+        result.latencies.push_back(static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - before).count()));
+    }
+    result.seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    result.ops += count;
+    result.items += count * itemsPerOp;
+}
+
+// One JSON object per result, percentiles by nearest rank
+void writeBenchResults(const vector<BenchResult>& results, uint64_t seed, ostream& out) {
+    out << "{\n  \"benchmark\": \"reservation-core\",\n  \"seed\": " << seed << ",\n  \"hardwareThreads\": " << thread::hardware_concurrency() << ",\n  \"results\": [";
+    for (size_t r = 0; r < results.size(); r++) {
+        const BenchResult& result = results[r];
+        vector<uint64_t> sorted = result.latencies;
+        sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](double q) -> uint64_t {
+            if (sorted.empty()) return 0;
+            size_t rank = static_cast<size_t>(ceil(q * sorted.size()));
+            return sorted[rank ? min(rank, sorted.size()) - 1 : 0];
+        };
+        double seconds = result.seconds > 0 ? result.seconds : 1e-9;
+        out << (r ? ",\n" : "\n") << "    {\"name\": " << jsonString(result.name) << ", \"flights\": " << result.flights
+            << ", \"ops\": " << result.ops << ", \"items\": " << result.items << ", \"refused\": " << result.refused
+            << ", \"seconds\": " << result.seconds << ", \"opsPerSecond\": " << (uint64_t)(result.ops / seconds)
+            << ", \"itemsPerSecond\": " << (uint64_t)(result.items / seconds)
+            << ", \"p50Ns\": " << percentile(0.5) << ", \"p99Ns\": " << percentile(0.99) << ", \"p999Ns\": " << percentile(0.999)
+            << ", \"maxNs\": " << (sorted.empty() ? 0 : sorted.back()) << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// Benchmarks the core operations on one synthetic network of flightCount flights
+void runBenchmarks(size_t flightCount, size_t opCount, uint64_t seed, vector<BenchResult>& results) {
+    string path = (filesystem::temp_directory_path() / ("airline_bench_" + to_string(flightCount) + ".txt")).string();
+    {
+        GeneratorConfig config;
+        config.flights = flightCount;
+        config.seed = seed;
+        ofstream schedule(path, ios::binary);
+        if (!schedule.is_open() || !ScheduleGenerator(config).writeSchedule(schedule)) {
+            cerr << "Error: Unable to write " << path << endl;
+            return;
+        }
+    }
+    mt19937_64 rng(seed);
+    auto newResult = [&](const char* name) -> BenchResult& {
+        results.push_back(BenchResult());
+        results.back().name = name;
+        results.back().flights = flightCount;
+        return results.back();
+    };
+    // Passes over the whole catalog are repeated until they add up to about 20M flights
+    size_t passes = max<size_t>(3, min<size_t>(1000, 20000000 / max<size_t>(1, flightCount)));
+
+    // Schedule load: small files are loaded again into fresh airlines, the last one is kept
+    unique_ptr<Airline> airline;
+    {
+        BenchResult& load = newResult("load");
+        size_t loads = max<size_t>(1, min<size_t>(1000, 1000000 / max<size_t>(1, flightCount)));
+        timeBenchOps(load, loads, flightCount, [&](size_t) {
+            airline.reset(new Airline("Bench"));
+            FileHandler fileHandler(path);
+            fileHandler.readDataParallel(*airline);
+            return airline->getFlights().size() == flightCount;
+        });
+    }
+    remove(path.c_str());
+
+    vector<Flight*> scheduled;
+    for (auto& entry : airline->getFlightsByStatus(FlightStatus::Scheduled)) scheduled.push_back(entry.second);
+    if (scheduled.empty()) return;
+
+    {
+        BenchResult& listing = newResult("listing");
+        vector<Flight*> found;
+        timeBenchOps(listing, passes, flightCount, [&](size_t i) {
+            airline->findOpenFlights(FlightStatus::Scheduled, static_cast<SeatType>(i % CABIN_COUNT), found);
+            return !found.empty();
+        });
+    }
+    {
+        BenchResult& pricing = newResult("pricing");
+        PricingEngine engine(1.2, 1.0, 1.3);
+        vector<double> grid;
+        timeBenchOps(pricing, passes, flightCount * CABIN_COUNT, [&](size_t) {
+            airline->priceFareGrid(engine, grid);
+            return !grid.empty();
+        });
+    }
+
+    // Bookings fill at most half of the seats of the Scheduled flights
+    size_t seatsPerFlight = 0;
+    for (int cabin = 0; cabin < CABIN_COUNT; cabin++) seatsPerFlight += scheduled[0]->getSeats().capacity(static_cast<SeatType>(cabin));
+    size_t bookings = min(opCount, scheduled.size() * seatsPerFlight / 2);
+    vector<Passenger*> passengers;
+    for (size_t i = 0; i < max<size_t>(1, bookings / 4); i++) passengers.push_back(airline->registerPassenger("Bench " + to_string(i + 1)));
+    {
+        BenchResult& booking = newResult("booking");
+        timeBenchOps(booking, bookings, 1, [&](size_t i) {
+            return airline->bookFlight(passengers[i % passengers.size()], scheduled[rng() % scheduled.size()], static_cast<SeatType>(rng() % CABIN_COUNT)) != nullptr;
+        });
+    }
+    {
+        // Every passenger gives up their latest reservation in turn
+        BenchResult& cancellation = newResult("cancellation");
+        size_t held = 0;
+        for (Passenger* passenger : passengers) held += passenger->getReservations().size();
+        size_t next = 0;
+        timeBenchOps(cancellation, held, 1, [&](size_t) {
+            while (passengers[next % passengers.size()]->getReservations().empty()) next++;
+            Passenger* passenger = passengers[next++ % passengers.size()];
+            airline->cancelReservation(passenger, static_cast<int>(passenger->getReservations().size()) - 1);
+            return true;
+        });
+    }
+    {
+        // Refused when the crew already has a clashing duty
+        BenchResult& crew = newResult("crewAssignment");
+        const vector<Crew*>& crews = airline->getCrews();
+        timeBenchOps(crew, min(opCount, flightCount), 1, [&](size_t) {
+            return airline->assignCrewToFlight(scheduled[rng() % scheduled.size()], crews[rng() % crews.size()]) == DutyConflict::None;
+        });
+    }
+    {
+        // Scheduled and Delayed flights switch back and forth
+        BenchResult& transitions = newResult("stateTransition");
+        timeBenchOps(transitions, opCount, 1, [&](size_t) {
+            Flight* flight = scheduled[rng() % scheduled.size()];
+            return airline->setFlightStatus(flight, flight->getStatus() == FlightStatus::Scheduled ? FlightStatus::Delayed : FlightStatus::Scheduled);
+        });
+    }
+}
+
+// Bench mode: --bench [--flights <n,n,...>] [--ops <n>] [--seed <n>] [--output <path>]
+// Benchmarks the core operations on synthetic networks of each size and writes the throughput
+// and latency percentiles as JSON to the output file, or stdout
+int runBenchMode(int argc, char* argv[]) {
+    string sizes = commandLineValue(argc, argv, "--flights", "37,10000,1000000");
+    size_t opCount = static_cast<size_t>(atoll(commandLineValue(argc, argv, "--ops", "100000").c_str()));
+    uint64_t seed = static_cast<uint64_t>(atoll(commandLineValue(argc, argv, "--seed", "1").c_str()));
+    string outputPath = commandLineValue(argc, argv, "--output", "");
+
+    vector<BenchResult> results;
+    stringstream list(sizes);
+    string size;
+    while (getline(list, size, ',')) {
+        size_t flightCount = static_cast<size_t>(atoll(size.c_str()));
+        if (!flightCount) continue;
+        cerr << "Benchmarking " << flightCount << " flights...\n";
+        runBenchmarks(flightCount, opCount, seed, results);
+    }
+    if (outputPath.empty()) {
+        writeBenchResults(results, seed, cout);
+        return 0;
+    }
+    ofstream out(outputPath);
+    if (!out.is_open()) {
+        cerr << "Error: Unable to write " << outputPath << endl;
+        return 1;
+    }
+    writeBenchResults(results, seed, out);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--sessions") return runSessionMode(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--stress") return runStressMode(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--roster") return runRosterMode(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--script") return runScriptMode(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--bench") return runBenchMode(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--generate") return runGenerateMode(argc, argv);
+
+	//generate random numbers for time but current time for booking of flight 
+    srand(time(0));
+
+    cout << " ~*~*~*~*~*~*~* Welcome to Airline Reservation System Simulation *~*~*~*~*~*~*~\n";
+    string a_name; // Airline name
+    cout << "Enter the name for the Airline : ";
+    getline(cin, a_name);
+
+    // Route factors come from the factor file and are reloaded whenever it changes
+    RouteFactors defaultFactors;
+    defaultFactors.seasonalFactor = 1.2;
+    defaultFactors.demandFactor = 1.3;
+    PricingTable pricing(defaultFactors);
+
+    // Create airline object
+    Airline airline(a_name);
+    // Initializing the reservation system
+    Reservation reservations;
+
+    // Load data using file handler
+    //read data from file that is created in drive
+    FileHandler fileHandler("final_draft.txt");
+    // A snapshot from the previous run brings back every booking, otherwise start from the schedule file
+    if (fileHandler.loadSnapshot(airline, SNAPSHOT_FILE)) {
+        cout << "Restored " << airline.getFlights().size() << " flights and " << airline.getPassengers().size() << " passengers from " << SNAPSHOT_FILE << ".\n";
+    }
+    else {
+        fileHandler.readDataParallel(airline);
+        cout << "Loaded " << fileHandler.getLastLoadStats().rows << " flights in " << fileHandler.getLastLoadStats().seconds * 1000 << " ms ("
+            << (size_t)fileHandler.getLastLoadStats().rowsPerSecond() << " rows/s).\n";
+        // Prices are random on load, so the journal needs this exact starting point to replay on
+        fileHandler.saveSnapshot(airline, SNAPSHOT_FILE);
+    }
+    // Re-apply what happened after the snapshot, then keep journaling every change
+    ReplayStats replayed = Journal::replay(JOURNAL_FILE, airline.getJournalSequence(), [&airline](uint64_t sequence, JournalOp op, JournalReader& reader) {
+        return airline.applyJournalRecord(sequence, op, reader);
+    });
+    if (replayed.applied) cout << "Replayed " << replayed.applied << " journaled operations.\n";
+    if (replayed.rejected) cerr << "Warning: " << replayed.rejected << " journaled operations could not be replayed" << endl;
+    if (replayed.tornTail) {
+        cerr << "Warning: Dropped a damaged record at the end of " << JOURNAL_FILE << endl;
+        if (!Journal::trimTail(JOURNAL_FILE, replayed.validBytes)) cerr << "Error: Unable to trim " << JOURNAL_FILE << endl;
+    }
+    Journal journal;
+    // Number new records after every record in the file, refused ones included
+    if (journal.open(JOURNAL_FILE, max(airline.getJournalSequence(), replayed.lastSequence))) airline.setJournal(&journal);
+    else cerr << "Error: Unable to open journal " << JOURNAL_FILE << endl;
+
+    fileHandler.loadFactors(pricing, defaultFactors);
+    FileWatcher factorWatcher(FACTOR_FILE, [&fileHandler, &pricing, defaultFactors] {
+        fileHandler.loadFactors(pricing, defaultFactors);
+    });
+
+
+    // Menu to choose observer state
+    cout << "\nChoose observer state:\n";
+    cout << "1. Passenger Observer\n";
+    cout << "2. Head Observer\n";
+    int observerChoice;
+    cin >> observerChoice;
+    // cin.fail() Checks if the previous input operation failed (e.g., if the user entered a non-integer).
+    while (cin.fail() || observerChoice < 1 || observerChoice > 2) {
+        cout << "Please Enter a Valid Observer Type: ";
+        cin >> observerChoice;
+    }
+    // Creating pointer observer object of base based on choice
+    Observer* observer = nullptr;
+    if (observerChoice == 1) {
+    	// dynamically allocating the derived object address  to pointer object of parent observer
+        observer = new PassengerObserver();
+    }
+    else if (observerChoice == 2) {
+        observer = new CrewObserver();
+    }
+    else {
+        cout << "Invalid choice\n";
+        return 1;
+    }
+    // Status, time and route changes reach the passengers and crew on board in the background,
+    // the head of operations sees every one of them
+    NotificationBus notificationBus(airline);
+    airline.setNotificationBus(&notificationBus);
+    if (observerChoice == 2) notificationBus.watch(observer);
+
+    bool Flag = 0; // for taking name of the passenger only once
+    //bool Flag2 = 0; // For Checking if the passenger has any reservations
+    Passenger* newPassenger = nullptr;
+    // Handling choices for functionalities
+    int choice;
+    do {
+        if (observerChoice == 2) observer->printNotices(cout);
+        else if (newPassenger) newPassenger->getObserver().printNotices(cout);
+        cout << "\nChoose an option:\n";
+        if (observerChoice == 1) {
+            cout << "1. Book a flight\n";
+            cout << "2. Cancel a reservation\n";
+            cout << "3. Modify a reservation\n";
+            cout << "4. Find a connection\n";
+            cout << "5. Exit\n";
+        }
+        else if (observerChoice == 2) {
+            cout << "1. Manage Crews to a flight\n"; // For adding and removing crews
+            cout << "2. Handle schedule conflicts\n";
+            cout << "3. Update flight status\n";
+            cout << "4. Reroute a flight\n";
+            cout << "5. Modify Flights \n"; // Adding and Removing
+            cout << "6. Exit\n";
+        }
+        cin >> choice;
+        if (observerChoice == 1 && !Flag && choice >= 1 && choice <= 3) {
+            // Identify the passenger once, a returning passenger gets their restored reservations back
+            string passengerName;
+            cout << "Enter passenger name: ";
+            getline(cin >> ws, passengerName); // ws for white space
+            newPassenger = airline.registerPassenger(passengerName);
+            Flag = 1;
+        }
+        int CrewNum;
+        int flightNum;
+        switch (choice) {
+        case 1: {
+            if (observerChoice == 1) {
+                // Book a flight
+                int seatChoice;
+                cout << "Choose seat type:\n";
+                cout << "1. Economy\n";
+                cout << "2. Business\n";
+                cout << "3. FirstClass\n";
+                cin >> seatChoice;
+                while (cin.fail() || seatChoice < 1 || seatChoice > 3) {
+                    cout << "Please Enter a valid value: \n";
+                    cin >> seatChoice;
+                }
+                SeatType chosenSeatType;
+                switch (seatChoice) {
+                case 1:
+                    chosenSeatType = SeatType::Economy;
+                    break;
+                case 2:
+                    chosenSeatType = SeatType::Business;
+                    break;
+                case 3:
+                    chosenSeatType = SeatType::FirstClass;
+                    break;
+                default:
+                    cout << "Invalid seat choice\n";
+                    continue; // Go back to the main menu
+                }
+                string seat = convertSeatTypeToString(chosenSeatType);
+                cout << "You have the following Avaiable flights : \n";
+                vector<Flight*> openFlights;
+                airline.findOpenFlights(FlightStatus::Scheduled, chosenSeatType, openFlights);
+                for (Flight* open : openFlights) {
+                    cout << " " << open->getId() << ": ~~~ " << open->getRoute() << ", Time : [ " << open->getTime() << " ] , Free " << seat << " seats : " << open->getSeats().freeSeats(chosenSeatType)
+                        << " , Fare : " << airline.quoteFare(open, chosenSeatType, pricing) << "$" << endl;
+                }
+                int flightNum = 0;
+                cout << "Enter the flight you want to take : ";
+                cin >> flightNum;
+                while (cin.fail() || !airline.getFlightById(flightNum) || airline.getFlightById(flightNum)->getStatus() != FlightStatus::Scheduled) {
+                    cout << "Please Enter a valid Flight Number : ";
+                    cin >> flightNum;
+                }
+
+                // The passenger pays the fare quoted before their own seat raises the demand
+                double fare = airline.quoteFare(airline.getFlightById(flightNum), chosenSeatType, pricing);
+                // Claim a seat in the chosen cabin, the flight stays Scheduled for other passengers
+                Reservation* reservation = airline.bookFlight(newPassenger, airline.getFlightById(flightNum), chosenSeatType);
+                if (!reservation) {
+                    cout << "Sorry , there are no free " << seat << " seats left on this flight.\n";
+                    break;
+                }
+
+                string loyalityCheck;
+                cout << "Are you eligible for the loyality program? \n ";
+                cin >> loyalityCheck;
+                cout << "\nYou are successfully Registered in the Flight heading " << airline.getFlightById(flightNum)->getRoute() << " , Seat : " << seat << " " << reservation->getSeatNumbers()[0] + 1 << " \n";
+                cout << "Regardless of your input , We have decided that you are " << (newPassenger->getEligibility() ? "" : "not ") << "eligible for the loyality Program.\n";
+                cout << "\n\nConsidering All the Current Factors , Your final price comes out to be : " << fare << "$ \n";
+            }
+            else if (observerChoice == 2) {
+                // Assign crew to a flight
+                cout << "Choose one of the following : \n";
+                cout << "1. Add crew to Flight\n";
+                cout << "2. Remove crew from Flight\n";
+                cout << "3. Fill the crew of every Flight automatically\n";
+                int choice = 0;
+                cin >> choice;
+                while (cin.fail() || choice < 1 || choice > 3) {
+                    cout << "Enter a Valid Option : ";
+                    cin >> choice;
+                }
+                switch (choice) {
+                case 1:
+                    cout << "You have the following Flights Available: \n";
+                    for (auto& entry : airline.getFlightsByStatus(FlightStatus::Scheduled)) {
+                        cout << " " << entry.first << ": ~~~ " << entry.second->getRoute() << ", Time : [ " << entry.second->getTime() << " ]" << endl;
+                    }
+                    
+                    cout << "Enter the Flight number that you want to add the crew to : ";
+                    cin >> flightNum;
+                    while (cin.fail() || !airline.getFlightById(flightNum) || airline.getFlightById(flightNum)->getStatus() != FlightStatus::Scheduled) {
+                        cout << "Please Enter a valid Flight Number : ";
+                        cin >> flightNum;
+                    }
+                    if (airline.getCrews().size()) {
+                        cout << "You Currently have the following crew : \n";
+                        for (int i = 0; i < airline.getCrews().size(); i++) {
+                            cout << " " << i + 1 << ". " << airline.getCrews()[i]->getName() << " [ " << airline.getCrews()[i]->getRole() << " ] \n";
+                        }
+                    }
+                    else cout << "No , Crew Available.\n";
+                    cout << "Enter the Crew Number that you want to assign to the this Flight : ";
+                    
+                    cin >> CrewNum;
+                    while (cin.fail() || CrewNum < 1 || CrewNum > airline.getCrews().size()) {
+                        cout << "Enter a Valid Crew no. : ";
+                        cin >> CrewNum;
+                    }
+                    if (airline.getCrews()[CrewNum - 1]->getCompliance()) {
+                        DutyConflict conflict = airline.assignCrewToFlight(airline.getFlightById(flightNum), airline.getCrews()[CrewNum - 1]);
+                        if (conflict == DutyConflict::None) cout << "Your Desired Crew is added to the desired Flight.\n";
+                        else if (conflict == DutyConflict::Overlap) cout << "This Crew is already on another Flight at that time.\n";
+                        else cout << "This Crew would not get " << MIN_REST_MINUTES / 60 << " hours of rest between its Flights.\n";
+                    }
+                    else cout << " This Crew's compliance with aviation regulations is subpar.\n So, Please select another one next time.\n";
+                    break;
+                case 2:
+                    cout << "You have the following Flights Available: \n";
+                    for (auto& entry : airline.getFlightsByStatus(FlightStatus::Scheduled)) {
+                        cout << " " << entry.first << ": ~~~ " << entry.second->getRoute() << ", Time : [ " << entry.second->getTime() << " ]" << endl;
+                    }
+                    
+                    cout << "Enter the Flight number that you want to remove the crew from : ";
+                    cin >> flightNum;
+                    while (cin.fail() || !airline.getFlightById(flightNum) || airline.getFlightById(flightNum)->getStatus() != FlightStatus::Scheduled) {
+                        cout << "Please Enter a valid Flight Number : ";
+                        cin >> flightNum;
+                    }
+                    if (airline.getFlightById(flightNum)->getCrew().size()) {
+                        cout << "You Currently have the following crew : \n";
+                        for (int i = 0; i < airline.getFlightById(flightNum)->getCrew().size(); i++) {
+                            cout << " " << i + 1 << ". " << airline.getFlightById(flightNum)->getCrew()[i]->getName() << " [ " << airline.getFlightById(flightNum)->getCrew()[i]->getRole() << " ] \n";
+                        }
+                    }
+                    else { 
+                        cout << "No , Crew Available.\n"; 
+                        break;
+                    }
+                    cout << "Enter the Crew Number that you want to remove from this flight : ";
+                    
+                    cin >> CrewNum;
+                    while (cin.fail() || CrewNum < 1 || CrewNum > airline.getFlightById(flightNum)->getCrew().size()) {
+                        cout << "Enter a Valid Crew no. : ";
+                        cin >> CrewNum;
+                    }
+                    airline.removeCrewFromFlight(airline.getFlightById(flightNum), CrewNum - 1);
+
+                    cout << "Your Desired Crew has been successfully removed from the inteneded Flight .\n";
+                    break;
+                case 3: {
+                    ThreadPool rosterPool;
+                    RosterSolver solver;
+                    vector<pair<Crew*, Flight*>> roster;
+                    RosterStats stats;
+                    solver.plan(airline, rosterPool, roster, stats);
+                    printRosterStats(stats, airline.applyRoster(roster), cout);
+                    break;
+                }
+                default:
+                    cout << "This line is not supposed to print.\n";
+                }
+            }
+            break;
+        }
+        case 2: {
+            if (observerChoice == 1) {
+                // Cancel a reservation
+                // Implement cancellation logic
+                int FlightNum = 0;
+                if (newPassenger->getReservations().size()) {
+                    cout << "Currently , you have the following Flights : \n";
+                    for (int i = 0; i < newPassenger->getReservations().size(); i++) {
+                        cout << " " << i + 1 << ". Heading " << newPassenger->getReservations()[i]->getFlights()[0]->getRoute() << "  [ " << newPassenger->getReservations()[i]->getSeat() << " ] , Time : " << "[ " << newPassenger->getReservations()[i]->getFlights()[0]->getTime() << " ]" << endl;
+                    }
+                    cout << "Enter the flight no. that you want to cancel : ";
+                    cin >> FlightNum;
+                    while (cin.fail() || FlightNum < 1 || FlightNum > newPassenger->getReservations().size()) {
+                        cout << "Enter a Valid Flight no. : ";
+                        cin >> FlightNum;
+                    }
+                    if (rand() % 2 == 1) {
+                        cout << "Sorry , Your Cancellation Request can't be executed.\n";
+                        cout << "Do you want to make a Special Request ? (yes/no)\n";
+                        string ans;
+                        getline(cin >> ws, ans);
+                        while (ans != "yes" && ans != "no") {
+                            cout << "Enter a valid Option: ";
+                            getline(cin >> ws, ans);
+                        }
+                        if (ans == "no") {
+                            cout << "Sure ! \n";
+                            break;
+                        }
+                        string request;
+                        cout << "Enter the request you want to give : \n";
+                        getline(cin >> ws, request);
+                        airline.setSpecialRequest(newPassenger, FlightNum - 1, request);
+                        cout << "\nConsidering Your Special Request , we have made our decision.\n\n";
+                    }
+                    if (rand() % 2 == 1) {
+                        airline.cancelReservation(newPassenger, FlightNum - 1);
+                        cout << "Your Desired Reservation has been successfully removed.\n";
+                    }
+                    else cout << "You can't Cancel this flight.\n";
+                }
+                else cout << "You don't have any Reservations.\n";
+            }
+            else if (observerChoice == 2) {
+                // Handle schedule conflicts
+                cout << "You have the following Flights Available: \n";
+                for (auto& entry : airline.getFlightsByStatus(FlightStatus::Scheduled)) {
+                    cout << " " << entry.first << ": ~~~ " << entry.second->getRoute() << ", Time : [ " << entry.second->getTime() << " ]" << endl;
+                }
+
+                cout << "Enter the Flight number that you want to change schedule of the crew to : ";
+                cin >> flightNum;
+                while (cin.fail() || !airline.getFlightById(flightNum) || airline.getFlightById(flightNum)->getStatus() != FlightStatus::Scheduled) {
+                    cout << "Please Enter a valid Flight Number : ";
+                    cin >> flightNum;
+                }
+                cout << "The next possible Time that you can set for this flight is : \n";
+                int newTime = airline.findFreeSlot(airline.getFlightById(flightNum)->getDeparture() + SLOT_MINUTES);
+                cout << formatFlightTime(newTime) << endl;
+                cout << "Do you want to Modify the previous time (yes/no)? ";
+                string timeopt;
+                cin >> timeopt;
+                while (timeopt != "yes" && timeopt != "no") {
+                    cout << "Give a valid answer : ";
+                    cin >> timeopt;
+                }
+                if (timeopt == "yes") {
+                    airline.setFlightTime(airline.getFlightById(flightNum), newTime);
+                }
+                cout << "Your Request has been fulfilled.\n";
+                // Flag the crew duties this flight now clashes with
+                vector<DutyViolation> violations;
+                airline.handleScheduleConflicts(airline.getFlightById(flightNum), violations);
+                for (const DutyViolation& violation : violations) {
+                    cout << " Warning : " << violation.crew->getName() << " works Flights " << violation.first->getId() << " and " << violation.second->getId()
+                        << (violation.conflict == DutyConflict::Overlap ? " at the same time.\n" : " without enough rest in between.\n");
+                }
+            }
+            break;
+        }
+        case 3: {
+            if (observerChoice == 1) {
+                // Modify a reservation
+                // Implement modification logic
+                int FlightNum = 0;
+                if (newPassenger->getReservations().size()) {
+                    cout << "Currently , you have the following Flights : \n";
+                    for (int i = 0; i < newPassenger->getReservations().size(); i++) {
+                        cout << " " << i + 1 << ". Heading " << newPassenger->getReservations()[i]->getFlights()[0]->getRoute() << "  [ " << newPassenger->getReservations()[i]->getSeat() << " ] , Time : " << "[ " << newPassenger->getReservations()[i]->getFlights()[0]->getTime() << " ]" << endl;
+                    }
+                    cout << "Enter the flight no. that you want to Modify : ";
+                    cin >> FlightNum;
+                    while (cin.fail() || FlightNum < 1 || FlightNum > newPassenger->getReservations().size()) {
+                        cout << "Enter a Valid Flight no. : ";
+                        cin >> FlightNum;
+                    }
+                    if (rand() % 2 == 1) {
+                        cout << "Sorry , Your Flight Modification Request can't be executed.\n";
+                        cout << "Do you want to make a Special Request ? (yes/no)\n";
+                        string ans;
+                        getline(cin >> ws, ans);
+                        while (ans != "yes" && ans != "no") {
+                            cout << "Enter a valid Option: ";
+                            getline(cin >> ws, ans);
+                        }
+                        if (ans == "no") {
+                            cout << "Sure ! \n";
+                            break;
+                        }
+                        string request;
+                        cout << "Enter the request you want to give : \n";
+                        getline(cin >> ws, request);
+                        airline.setSpecialRequest(newPassenger, FlightNum - 1, request);
+                        cout << "\nConsidering Your Special Request , we have made our decision.\n\n";
+                    }
+                    cout << "You have the option to modify which kind of seat you want to reserve.\n";
+                    int seatChoice;
+                    cout << "Please choose the seat type:\n";
+                    cout << "1. Economy\n";
+                    cout << "2. Business\n";
+                    cout << "3. FirstClass\n";
+                    cin >> seatChoice;
+                    while (cin.fail() || seatChoice < 1 || seatChoice > 3) {
+                        cout << "Please Enter a valid value: \n";
+                        cin >> seatChoice;
+                    }
+                    SeatType chosenSeatType = static_cast<SeatType>(seatChoice - 1);
+                    if (convertStringToSeatType(newPassenger->getReservations()[FlightNum - 1]->getSeat()) == chosenSeatType)
+                        cout << "You already have this seat type.\n";
+                    else if (airline.modifyReservation(newPassenger, FlightNum - 1, chosenSeatType))
+                        cout << "Your Given Seat Type is Successfully Modified.\n";
+                    else cout << "Sorry , there are no free " << convertSeatTypeToString(chosenSeatType) << " seats left on this flight.\n";
+                }
+                else cout << "You don't have any Reservations.\n";
+            }
+            else if (observerChoice == 2) {
+                // Update flight status
+                cout << "You have the following Flights Available: \n";
+                for (int i = 0; i < airline.getFlights().size(); i++) {
+                    //string time = to_string((i + 1) % 12 + 1) + ((i % 24) < 13 ? " pm" : " am") + ", Day " + to_string(i / 10 + 1);
+                    //if (airline.getFlights()[i]->getStatus() == FlightStatus::Scheduled) {
+                    cout << " " << airline.getFlights()[i]->getId() << ": ~~~ " << airline.getFlights()[i]->getRoute() << ", Time : [ " << airline.getFlights()[i]->getTime() << " ]" << endl;
+                    //}
+                }
+                cout << "Select the one that you want to update the state of : \n";
+                cin >> flightNum;
+                while (cin.fail() || !airline.getFlightById(flightNum)) {
+                    cout << "Please Enter a valid Flight Number : ";
+                    cin >> flightNum;
+                }
+                cout << "The Current State of the given flight is : " << airline.getFlightById(flightNum)->getCurrentState()->getName() << ". \n";
+                cout << "It has changed state " << airline.getFlightById(flightNum)->getTotalTransitions() << " time(s) so far.\n";
+                cout << "Select any of the following Choices that you want the state to update to: \n";
+                cout << "1. Scheduled \n2. Delayed \n3.Cancelled\n";
+                int StChoice;
+                cin >> StChoice;
+                while (cin.fail() || StChoice < 1 || StChoice > 3) {
+                    cout << "Enter a valid Choice : ";
+                    cin >> StChoice;
+                }
+                FlightStatus newStatus = FlightStatus::Scheduled;
+                switch (StChoice) {
+                case 1:
+                    newStatus = FlightStatus::Scheduled;
+                    break;
+                case 2:
+                    newStatus = FlightStatus::Delayed;
+                    break;
+                case 3:
+                    newStatus = FlightStatus::Cancelled;
+                    break;
+                default:
+                    cout << "This line is not supposed to print.\n";
+                }
+                if (airline.setFlightStatus(airline.getFlightById(flightNum), newStatus)) {
+                    cout << "Your Required State has been set Successfully.\n";
+                    if (newStatus == FlightStatus::Cancelled) {
+                        // Move the passengers of the cancelled flight onto other connections straight away
+                        ThreadPool rebookPool;
+                        ReaccommodationEngine engine;
+                        ReaccommodationStats stats;
+                        engine.run(airline, { airline.getFlightById(flightNum) }, pricing, rebookPool, stats);
+                        printReaccommodationStats(stats, cout);
+                    }
+                }
+                else cout << "A " << airline.getFlightById(flightNum)->getCurrentState()->getName() << " flight can't be changed to " << FlightState::forStatus(newStatus)->getName() << ".\n";
+            }
+            break;
+        }
+        case 4: {
+            if (observerChoice == 1) {
+                // Find a connection, possibly over several flights
+                string from, to;
+                cout << "Enter the airport you are leaving from (e.g. NYC) : ";
+                cin >> from;
+                cout << "Enter the airport you are going to (e.g. LON) : ";
+                cin >> to;
+                transform(from.begin(), from.end(), from.begin(), ::toupper);
+                transform(to.begin(), to.end(), to.begin(), ::toupper);
+                uint32_t origin = airline.getAirports().find(from);
+                uint32_t destination = airline.getAirports().find(to);
+                if (origin == NO_AIRPORT || destination == NO_AIRPORT || origin == destination) {
+                    cout << "We don't fly between those airports.\n";
+                    break;
+                }
+                int maxStops = 0, orderChoice = 0;
+                cout << "How many stops at most (0-3) : ";
+                cin >> maxStops;
+                while (cin.fail() || maxStops < 0 || maxStops > 3) {
+                    cin.clear();
+                    cin.ignore(10000, '\n');
+                    cout << "Please Enter a number from 0 to 3 : ";
+                    cin >> maxStops;
+                }
+                cout << "Sort by 1. Lowest Fare  2. Earliest Arrival : ";
+                cin >> orderChoice;
+                ItineraryOrder order = orderChoice == 2 ? ItineraryOrder::Arrival : ItineraryOrder::Price;
+
+                ItineraryPlanner planner;
+                planner.build(airline, SeatType::Economy, pricing);
+                vector<Itinerary> itineraries;
+                planner.search(origin, destination, 0, maxStops, order, 5, itineraries);
+                if (itineraries.empty()) {
+                    cout << "Sorry , there is no connection with that many stops.\n";
+                    break;
+                }
+                cout << "You have the following Economy connections : \n";
+                for (size_t i = 0; i < itineraries.size(); i++) {
+                    cout << " " << i + 1 << ". Fare : " << itineraries[i].fare << "$ , Arrives : [ " << formatFlightTime(itineraries[i].arrival) << " ]" << endl;
+                    for (Flight* leg : itineraries[i].legs) {
+                        cout << "      " << leg->getId() << ": ~~~ " << leg->getRoute() << ", Time : [ " << leg->getTime() << " ]" << endl;
+                    }
+                }
+                cout << "Book each flight of a connection with option 1.\n";
+                break;
+            }
+            else if (observerChoice == 2) {
+                // Reroute a flight
+                cout << "You have the following Flights Available: \n";
+                for (auto& entry : airline.getFlightsByStatus(FlightStatus::Scheduled)) {
+                    cout << " " << entry.first << ": ~~~ " << entry.second->getRoute() << ", Time : [ " << entry.second->getTime() << " ]" << endl;
+                }
+                cout << "Enter the Flight number that you want to Reroute : ";
+                cin >> flightNum;
+                while (cin.fail() || !airline.getFlightById(flightNum) || airline.getFlightById(flightNum)->getStatus() != FlightStatus::Scheduled) {
+                    cout << "Please Enter a valid Flight Number : ";
+                    cin >> flightNum;
+                }
+                cout << "Enter the Route you want it to follow (e.g. NYC-LON) : \n";
+                string newRoute;
+                cin >> newRoute;
+                transform(newRoute.begin(), newRoute.end(), newRoute.begin(), ::toupper);
+                while (!airline.rerouteFlight(airline.getFlightById(flightNum), newRoute)) {
+                    cout << "Please Enter a valid Route (two airport codes such as NYC-LON) : ";
+                    cin >> newRoute;
+                    transform(newRoute.begin(), newRoute.end(), newRoute.begin(), ::toupper);
+                }
+                cout << "Your desired Flight has been rerouted successfully.\n";
+            }
+            break;
+        }
+        case 5: {
+            if (observerChoice == 1) {
+                cout << "Exiting...\n";
+                break;
+            }
+            // Logic To Add/Remove Flights
+            if (observerChoice == 2) {
+                cout << "Select one of the following options: \n";
+                cout << "1. Add Flight\n"
+                    << "2. Remove Flight\n"
+                    << "3. Update Route Pricing\n";
+                int flChoice;
+                cin >> flChoice;
+                while (cin.fail() || flChoice < 1 || flChoice > 3) {
+                    cout << "Choose a Valid Option: ";
+                    cin >> flChoice;
+                }
+                if (flChoice == 1) {
+                    cout << "Enter the route for the new Flight (e.g. NYC-LON).\n";
+                    string newRoute;
+                    cin >> newRoute;
+                    transform(newRoute.begin(), newRoute.end(), newRoute.begin(), ::toupper);
+                    string_view newOrigin, newDestination;
+                    while (!splitRoute(newRoute, newOrigin, newDestination)) {
+                        cout << "Please Enter a valid Route (two airport codes such as NYC-LON) : ";
+                        cin >> newRoute;
+                        transform(newRoute.begin(), newRoute.end(), newRoute.begin(), ::toupper);
+                    }
+                    // Offer the first free slots from 10 pm on Day 7
+                    int freeTimes[4];
+                    freeTimes[0] = airline.findFreeSlot(6 * 24 * 60 + 22 * 60);
+                    for (int i = 1; i < 4; i++) freeTimes[i] = airline.findFreeSlot(freeTimes[i - 1] + SLOT_MINUTES);
+                    cout << "Now select any of the following times : \n";
+                    for (int i = 0; i < 4; i++) cout << i + 1 << ". " << formatFlightTime(freeTimes[i]) << "\n";
+                    int timeChoice;
+                    cin >> timeChoice;
+                    while (cin.fail() || timeChoice < 1 || timeChoice > 4) {
+                        cout << "Enter a Valid Option: ";
+                        cin >> timeChoice;
+                    }
+                    airline.scheduleFlight(newRoute, freeTimes[timeChoice - 1]);
+                    cout << "Your Desired Flight has been added successfully.\n";
+                }
+                else if (flChoice == 3) {
+                    cout << "Enter the route (or * for every other route) : ";
+                    string factorRoute;
+                    cin >> factorRoute;
+                    double basePrice, demandFactor, seasonalFactor, eventFactor;
+                    cout << "Enter base price (0 keeps each flight's price), demand, seasonal and event factors : ";
+                    cin >> basePrice >> demandFactor >> seasonalFactor >> eventFactor;
+                    while (cin.fail()) {
+                        cin.clear();
+                        cin.ignore(10000, '\n');
+                        cout << "Enter four numbers : ";
+                        cin >> basePrice >> demandFactor >> seasonalFactor >> eventFactor;
+                    }
+                    if (fileHandler.updateData(factorRoute, basePrice, demandFactor, seasonalFactor, eventFactor)) {
+                        fileHandler.loadFactors(pricing, defaultFactors);
+                        cout << "Pricing for " << factorRoute << " has been updated.\n";
+                    }
+                    else cout << "Sorry , the pricing file could not be written.\n";
+                }
+                else {
+                    cout << "You have the following Flights Available: \n";
+                    for (int i = 0; i < airline.getFlights().size(); i++) {
+                        //string time = to_string((i + 1) % 12 + 1) + ((i % 24) < 13 ? " pm" : " am") + ", Day " + to_string(i / 10 + 1);
+                        //if (airline.getFlights()[i]->getStatus() == FlightStatus::Scheduled) {
+                            cout << " " << airline.getFlights()[i]->getId() << ": ~~~ " << airline.getFlights()[i]->getRoute() << ", Time : [ " << airline.getFlights()[i]->getTime() << " ]" << endl;
+                        //}
+                    }
+
+                    cout << "Enter the Flight number that you want to remove : ";
+                    cin >> flightNum;
+                    while (cin.fail() || !airline.getFlightById(flightNum)) {
+                        cout << "Please Enter a valid Flight Number : ";
+                        cin >> flightNum;
+                    }
+                    if (airline.removeFlight(airline.getFlightById(flightNum)))
+                        cout << "Your intended Flight has been removed successfully.\n";
+                    else cout << "This Flight still has passengers booked on it, so it can't be removed.\n";
+                }
+            }
+            break;
+        }
+        case 6: {
+            if (observerChoice == 2) {
+                cout << "Exiting...\n";
+                break;
+            }
+        }
+        default:
+            cout << "\nInvalid choice. Please Enter Again: ";
+        }
+    } while ((choice != 6 && observerChoice == 2) || (choice != 5 && observerChoice == 1));
+    notificationBus.unwatch(observer);
+    delete observer;
+    // Once the snapshot covers every journaled operation the journal can start over
+    if (fileHandler.saveSnapshot(airline, SNAPSHOT_FILE)) journal.truncate(JOURNAL_FILE);
+    else cerr << "Error: Unable to write " << SNAPSHOT_FILE << endl;
+    return 0;
+}